@@ -1,7 +1,8 @@
 import streamlit as st
 import subprocess
-import re
 import os
+import json
+import socket
 from pathlib import Path
 
 st.set_page_config(page_title="StockSense", layout="wide")
@@ -14,227 +15,311 @@ st.title("📊 StockSense - Advanced Stock Analytics")
 current_file = Path(__file__).resolve()
 frontend_dir = current_file.parent
 project_root = frontend_dir.parent
-stocks_exe = project_root / "src" / "stocks"
+src_dir = project_root / "src"
+stocks_exe = src_dir / "stocks"
+socket_path = src_dir / "stocks.sock"  # `stocks --serve` listens here when run from src
+stocks_lib = src_dir / "libstocksense.so"  # optional in-process analytics (stocksense_c.h)
+build_hint = "Please compile the C++ program first:\n```bash\ncd src\ng++ -std=c++17 main.cpp StockDataLoader.cpp StockAnalytics.cpp MappedFile.cpp PriceCsvParser.cpp SeriesCache.cpp Fft.cpp SimdKernels.cpp IndicatorPipeline.cpp GridSearch.cpp WalkForward.cpp Universe.cpp Portfolio.cpp AnalysisServer.cpp ReportFormat.cpp UnixSocket.cpp StreamEngine.cpp ReplayEngine.cpp -o stocks\n```\nOptionally keep `./stocks --serve` running in `src`, or build `libstocksense.so` (see `src/stocksense_c.h`), for instant repeat analyses."
 
 
 # Sidebar
 ticker = st.sidebar.selectbox("Stock", ["AAPL", "MSFT", "GOOGL", "TSLA", "AMZN", "NVDA", "META"])
 
-if st.sidebar.button("Analyze", type="primary"):
+@st.cache_resource
+def load_library():
+    """libstocksense bound through ctypes, or None when it is not built"""
+    if not stocks_lib.exists():
+        return None
+    from stocksense import StockSense
+    return StockSense(stocks_lib)
+
+
+def analyze_in_process(ticker):
+    """Analysis dict from the shared library, without starting a process.
+
+    Only bundled CSVs are read this way (the library resolves paths against
+    the Streamlit working directory); None lets the caller fall back."""
+    lib = load_library()
+    csv = src_dir / f"{ticker}.csv"
+    if lib is None or not csv.exists():
+        return None
+    with lib.analyze(str(csv), allow_fetch=False) as analysis:
+        return analysis.report()
+
+
+def query_daemon(ticker, timeout=60.0):
+    """Ask a running `stocks --serve` daemon (src/stocks.sock) for ticker.
+
+    Returns the analysis dict, or None when no daemon is listening so the
+    caller can fall back to running the executable with --format=json.
+    """
+    if not socket_path.exists():
+        return None
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.settimeout(timeout)
+            sock.connect(str(socket_path))
+            sock.sendall(f"analyze {ticker}\n".encode())
+            reply = sock.makefile("rb").readline()
+    except OSError:
+        return None
+    if not reply:
+        return None
+    response = json.loads(reply)
+    if not response.get("ok"):
+        raise RuntimeError(response.get("error", "analysis failed"))
+    return response["analysis"]
+
+
+def fmt(value, digits=4, scale=1.0):
+    """Format a JSON number like the C++ text report (null -> N/A)"""
+    return "N/A" if value is None else f"{value * scale:.{digits}f}"
+
+
+def metrics_from_json(a):
+    """Analysis JSON (daemon reply or --format=json) -> display strings,
+    formatted like the C++ text report"""
+    strategies = {}
+    for s in a["strategies"]:
+        strategies[s["name"].replace(" Strategy", "").strip()] = {
+            'return': fmt(s["totalReturn"], scale=100.0),
+            'sharpe': fmt(s["sharpe"]),
+            'drawdown': fmt(s["maxDrawdown"], scale=100.0),
+            'win_rate': fmt(s["winRate"], scale=100.0),
+            'score': fmt(s["score"]),
+        }
+    return {
+        'latest_date': a["latestDate"],
+        'latest_close': fmt(a["latestClose"]),
+        'sma_20': fmt(a["sma20"]),
+        'volatility': fmt(a["volatility20"]),
+        'mean_return': fmt(a["returns"]["mean"]),
+        'sharpe': fmt(a["sharpe"]),
+        'ytd': fmt(a["periodReturn"], scale=100.0),
+        'max_drawdown': fmt(a["maxDrawdown"], scale=100.0),
+        'bb_middle': fmt(a["bollinger"]["middle"]),
+        'bb_upper': fmt(a["bollinger"]["upper"]),
+        'bb_lower': fmt(a["bollinger"]["lower"]),
+        'bb_status': a["bollinger"]["status"],
+        'hurst': fmt(a["hurst"]),
+        'hurst_behavior': a["hurstBehavior"] or "N/A",
+        'acf_1': fmt(a["acf"]["lag1"]),
+        'acf_5': fmt(a["acf"]["lag5"]),
+        'acf_20': fmt(a["acf"]["lag20"]),
+        'strategies': strategies,
+        'recommended_strategy': a["recommended"],
+        'signal_strength': fmt(a["signal"]),
+        'action': a["action"] or "N/A",
+        'raw': json.dumps(a, indent=2),
+    }
+
+
+def run_analysis(ticker):
+    """Metrics for ticker from libstocksense if it is built, else from the
+    daemon if one is running, else from a one-off run of the executable.
+    Returns None after reporting an error."""
+    try:
+        analysis = analyze_in_process(ticker)
+        if analysis is None:
+            analysis = query_daemon(ticker)
+    except RuntimeError as e:
+        st.error(f"Error running analysis: {e}")
+        return None
+    if analysis is not None:
+        return metrics_from_json(analysis)
+
     # Verify executable exists before running
     if not stocks_exe.exists():
         st.error(f"Executable not found at: {stocks_exe}")
-        st.info("Please compile the C++ program first:\n```bash\ncd src\ng++ -std=c++17 main.cpp StockDataLoader.cpp StockAnalytics.cpp -o stocks\n```")
-    else:
-        with st.spinner(f"Analyzing {ticker}..."):
-            # Call C++ backend - cwd should be project_root/src (sibling of frontend)
-            src_dir = project_root / "src"
-            result = subprocess.run(
-                [str(stocks_exe), ticker], 
-                capture_output=True, 
-                text=True,
-                cwd=str(src_dir)
-            )
+        st.info(build_hint)
+        return None
+
+    # Call C++ backend - cwd should be project_root/src (sibling of frontend)
+    result = subprocess.run(
+        [str(stocks_exe), ticker, "--format=json"],
+        capture_output=True,
+        text=True,
+        cwd=str(src_dir)
+    )
+    if result.returncode != 0:
+        st.error("Error running analysis")
+        st.code(result.stdout + result.stderr)
+        return None
+    try:
+        analysis = json.loads(result.stdout)
+    except json.JSONDecodeError:
+        # A build from before --format=json prints the text report instead
+        st.error(f"{stocks_exe} did not answer in JSON; it is probably an outdated build")
+        st.info(build_hint)
+        return None
+    return metrics_from_json(analysis)
+
+
+if st.sidebar.button("Analyze", type="primary"):
+    with st.spinner(f"Analyzing {ticker}..."):
+        metrics = run_analysis(ticker)
+
+    if metrics is not None:
+        st.success(f"Analysis complete for {ticker}!")
+
+        latest_date = metrics['latest_date']
+        latest_close = metrics['latest_close']
+        sma_20 = metrics['sma_20']
+        volatility = metrics['volatility']
+        mean_return = metrics['mean_return']
+        sharpe = metrics['sharpe']
+        ytd = metrics['ytd']
+        max_drawdown = metrics['max_drawdown']
+        bb_middle = metrics['bb_middle']
+        bb_upper = metrics['bb_upper']
+        bb_lower = metrics['bb_lower']
+        bb_status = metrics['bb_status']
+        hurst = metrics['hurst']
+        hurst_behavior = metrics['hurst_behavior']
+        acf_1 = metrics['acf_1']
+        acf_5 = metrics['acf_5']
+        acf_20 = metrics['acf_20']
+        strategies = metrics['strategies']
+        recommended_strategy = metrics['recommended_strategy']
+        signal_strength = metrics['signal_strength']
+        action = metrics['action']
         
-        if result.returncode != 0:
-            st.error("Error running analysis")
-            st.code(result.stderr)
-        else:
-            output = result.stdout
-            st.success(f"Analysis complete for {ticker}!")
-            
-            # Parse the output
-            def extract_value(pattern, text, group=1):
-                match = re.search(pattern, text)
-                return match.group(group) if match else "N/A"
-            
-            # Extract metrics
-            latest_date = extract_value(r"Latest date:\s+(.+)", output)
-            latest_close = extract_value(r"Latest close:\s+([\d.]+)", output)
-            sma_20 = extract_value(r"20-day SMA:\s+([\d.]+)", output)
-            volatility = extract_value(r"20-day volatility:\s+([\d.]+)", output)
-            mean_return = extract_value(r"Mean:\s+([\d.-]+)", output)
-            sharpe = extract_value(r"Sharpe Ratio \(daily\):\s+([\d.-]+)", output)
-            ytd = extract_value(r"Year-to-date performance:\s+([\d.-]+)%", output)
-            max_drawdown = extract_value(r"Max drawdown:\s+([\d.-]+)%", output)
-            
-            # Bollinger Bands
-            bb_middle = extract_value(r"Middle \(SMA\):\s+([\d.]+)", output)
-            bb_upper = extract_value(r"Upper band:\s+([\d.]+)", output)
-            bb_lower = extract_value(r"Lower band:\s+([\d.]+)", output)
-            bb_status = extract_value(r"Status:\s+(.+)", output)
-            
-            # Hurst
-            hurst = extract_value(r"Hurst Exponent:\s+([\d.]+)", output)
-            hurst_behavior = extract_value(r"Behavior:\s+(.+)", output)
-            
-            # ACF
-            acf_1 = extract_value(r"Lag-1 \(daily\):\s+([\d.-]+)", output)
-            acf_5 = extract_value(r"Lag-5 \(weekly\):\s+([\d.-]+)", output)
-            acf_20 = extract_value(r"Lag-20 \(monthly\):\s+([\d.-]+)", output)
-            
-            # Strategy results - match the actual C++ format
-            strategies = {}
-            # The C++ outputs: "Mean Reversion Strategy:\n  Total Return:..."
-            strategy_blocks = re.findall(
-                r"^(.+?Strategy):\s*\n\s+Total Return:\s+([\d.-]+)%\s*\n\s+Sharpe Ratio:\s+([\d.-]+)\s*\n\s+Max Drawdown:\s+([\d.-]+)%\s*\n\s+Win Rate:\s+([\d.]+)%\s*\n\s+Overall Score:\s+([\d.-]+)",
-                output,
-                re.MULTILINE
-            )
-            
-            
-            for block in strategy_blocks:
-                name, ret, sharpe_s, dd, wr, score = block
-                # Remove the word "Strategy" from the name for display
-                clean_name = name.replace(" Strategy", "").strip()
-                strategies[clean_name] = {
-                    'return': ret,
-                    'sharpe': sharpe_s,
-                    'drawdown': dd,
-                    'win_rate': wr,
-                    'score': score
+        # ===== OVERVIEW SECTION =====
+        st.header("📈 Market Overview")
+        
+        col1, col2, col3, col4, col5 = st.columns(5)
+        col1.metric("Latest Close", f"${latest_close}", latest_date)
+        col2.metric("Volatility", f"{float(volatility)*100:.2f}%" if volatility != "N/A" else "N/A")
+        col3.metric("20d SMA", f"${sma_20}")
+        col4.metric("Sharpe Ratio", sharpe)
+        col5.metric("YTD", f"{ytd}%")
+        
+        # ===== STRATEGY RECOMMENDATIONS =====
+        st.header("🎯 Strategy Recommendation")
+        
+        # Best strategy highlight
+        st.success(f"### Recommended: {recommended_strategy}")
+        
+        col1, col2 = st.columns([2, 1])
+        
+        with col1:
+            # Strategy comparison table
+            if strategies:
+                import pandas as pd
+                strategy_data = {
+                    'Strategy': list(strategies.keys()),
+                    'Total Return': [f"{v['return']}%" for v in strategies.values()],
+                    'Sharpe': [v['sharpe'] for v in strategies.values()],
+                    'Drawdown': [f"{v['drawdown']}%" for v in strategies.values()],
+                    'Win Rate': [f"{v['win_rate']}%" for v in strategies.values()],
+                    'Score': [v['score'] for v in strategies.values()]
                 }
+                df = pd.DataFrame(strategy_data)
+                st.dataframe(df, width="stretch", hide_index=True)
+        
+        with col2:
+            st.metric("Signal Strength", signal_strength)
             
-            recommended_strategy = extract_value(r"RECOMMENDED STRATEGY:\s+(.+)", output)
-            signal_strength = extract_value(r"Current Signal Strength:\s+([-\d.]+)", output)
-            action = extract_value(r"Action Recommendation:\s+(.+)", output)
-            
-            # ===== OVERVIEW SECTION =====
-            st.header("📈 Market Overview")
-            
-            col1, col2, col3, col4, col5 = st.columns(5)
-            col1.metric("Latest Close", f"${latest_close}", latest_date)
-            col2.metric("Volatility", f"{float(volatility)*100:.2f}%" if volatility != "N/A" else "N/A")
-            col3.metric("20d SMA", f"${sma_20}")
-            col4.metric("Sharpe Ratio", sharpe)
-            col5.metric("YTD", f"{ytd}%")
-            
-            # ===== STRATEGY RECOMMENDATIONS =====
-            st.header("🎯 Strategy Recommendation")
+            # Color code the action
+            if "BUY" in action.upper():
+                st.success(f"**Action: {action}**")
+            elif "SELL" in action.upper():
+                st.error(f"**Action: {action}**")
+            else:
+                st.info(f"**Action: {action}**")
             
-            # Best strategy highlight
-            st.success(f"### Recommended: {recommended_strategy}")
+            # Handle both positive (buy) and negative (sell) signals
+            sig_val = float(signal_strength) if signal_strength != "N/A" else 0.0
             
-            col1, col2 = st.columns([2, 1])
+            # Normalize signal to 0-1 range for progress bar
+            # Signals range roughly from -10 (strong sell) to +10 (strong buy)
+            # Map to 0 (strong sell) to 1 (strong buy), with 0.5 as neutral
+            normalized = (sig_val + 10) / 20  # Maps -10 to 0, 0 to 0.5, +10 to 1
+            normalized = max(0, min(1, normalized))  # Clamp to [0, 1]
             
-            with col1:
-                # Strategy comparison table
-                if strategies:
-                    import pandas as pd
-                    strategy_data = {
-                        'Strategy': list(strategies.keys()),
-                        'Total Return': [f"{v['return']}%" for v in strategies.values()],
-                        'Sharpe': [v['sharpe'] for v in strategies.values()],
-                        'Drawdown': [f"{v['drawdown']}%" for v in strategies.values()],
-                        'Win Rate': [f"{v['win_rate']}%" for v in strategies.values()],
-                        'Score': [v['score'] for v in strategies.values()]
-                    }
-                    df = pd.DataFrame(strategy_data)
-                    st.dataframe(df, width="stretch", hide_index=True)
+            # Color the progress bar based on signal direction
+            if sig_val > 5:
+                bar_text = f"🟢 Strong Buy: {sig_val:.1f}"
+            elif sig_val > 0:
+                bar_text = f"🟢 Buy: {sig_val:.1f}"
+            elif sig_val > -5:
+                bar_text = f"🟡 Neutral: {sig_val:.1f}"
+            elif sig_val > -10:
+                bar_text = f"🔴 Sell: {sig_val:.1f}"
+            else:
+                bar_text = f"🔴 Strong Sell: {sig_val:.1f}"
             
-            with col2:
-                st.metric("Signal Strength", signal_strength)
-                
-                # Color code the action
-                if "BUY" in action.upper():
-                    st.success(f"**Action: {action}**")
-                elif "SELL" in action.upper():
-                    st.error(f"**Action: {action}**")
-                else:
-                    st.info(f"**Action: {action}**")
-                
-                # Handle both positive (buy) and negative (sell) signals
-                sig_val = float(signal_strength) if signal_strength != "N/A" else 0.0
-                
-                # Normalize signal to 0-1 range for progress bar
-                # Signals range roughly from -10 (strong sell) to +10 (strong buy)
-                # Map to 0 (strong sell) to 1 (strong buy), with 0.5 as neutral
-                normalized = (sig_val + 10) / 20  # Maps -10 to 0, 0 to 0.5, +10 to 1
-                normalized = max(0, min(1, normalized))  # Clamp to [0, 1]
-                
-                # Color the progress bar based on signal direction
-                if sig_val > 5:
-                    bar_text = f"🟢 Strong Buy: {sig_val:.1f}"
-                elif sig_val > 0:
-                    bar_text = f"🟢 Buy: {sig_val:.1f}"
-                elif sig_val > -5:
-                    bar_text = f"🟡 Neutral: {sig_val:.1f}"
-                elif sig_val > -10:
-                    bar_text = f"🔴 Sell: {sig_val:.1f}"
-                else:
-                    bar_text = f"🔴 Strong Sell: {sig_val:.1f}"
-                
-                st.progress(normalized, text=bar_text)
-            
-            # ===== TECHNICAL INDICATORS =====
-            st.header("📊 Technical Indicators")
+            st.progress(normalized, text=bar_text)
+        
+        # ===== TECHNICAL INDICATORS =====
+        st.header("📊 Technical Indicators")
+        
+        tab1, tab2, tab3 = st.tabs(["Bollinger Bands (20-day)", "Hurst Exponent", "Autocorrelation"])
+        
+        with tab1:
+            col1, col2, col3 = st.columns(3)
+            col1.metric("Upper Band", f"${bb_upper}")
+            col2.metric("Middle (SMA)", f"${bb_middle}")
+            col3.metric("Lower Band", f"${bb_lower}")
             
-            tab1, tab2, tab3 = st.tabs(["Bollinger Bands (20-day)", "Hurst Exponent", "Autocorrelation"])
+            if "Overbought" in bb_status:
+                st.warning(f"**Status: {bb_status}**")
+            elif "Oversold" in bb_status:
+                st.info(f"**Status: {bb_status}**")
+            else:
+                st.success(f"**Status: {bb_status}**")
+        
+        with tab2:
+            st.metric("Hurst Exponent", hurst)
             
-            with tab1:
-                col1, col2, col3 = st.columns(3)
-                col1.metric("Upper Band", f"${bb_upper}")
-                col2.metric("Middle (SMA)", f"${bb_middle}")
-                col3.metric("Lower Band", f"${bb_lower}")
-                
-                if "Overbought" in bb_status:
-                    st.warning(f"**Status: {bb_status}**")
-                elif "Oversold" in bb_status:
-                    st.info(f"**Status: {bb_status}**")
+            interpretation = ""
+            if hurst != "N/A":
+                h_val = float(hurst)
+                if h_val > 0.55:
+                    interpretation = """
+                    **Trending/Persistent Behavior**
+                    - H > 0.55 indicates momentum
+                    - Trends tend to continue
+                    - Use momentum-based strategies
+                    """
+                elif h_val < 0.45:
+                    interpretation = """
+                    **Mean-Reverting Behavior**
+                    - H < 0.45 indicates reversals
+                    - Prices bounce back to average
+                    - Use contrarian strategies
+                    """
                 else:
-                    st.success(f"**Status: {bb_status}**")
-            
-            with tab2:
-                st.metric("Hurst Exponent", hurst)
-                
-                interpretation = ""
-                if hurst != "N/A":
-                    h_val = float(hurst)
-                    if h_val > 0.55:
-                        interpretation = """
-                        **Trending/Persistent Behavior**
-                        - H > 0.55 indicates momentum
-                        - Trends tend to continue
-                        - Use momentum-based strategies
-                        """
-                    elif h_val < 0.45:
-                        interpretation = """
-                        **Mean-Reverting Behavior**
-                        - H < 0.45 indicates reversals
-                        - Prices bounce back to average
-                        - Use contrarian strategies
-                        """
-                    else:
-                        interpretation = """
-                        **Random Walk Behavior**
-                        - H ≈ 0.5 indicates randomness
-                        - Past doesn't predict future
-                        - Technical analysis less effective
-                        """
-                
-                st.info(interpretation or hurst_behavior)
-            
-            with tab3:
-                import pandas as pd
-                acf_data = pd.DataFrame({
-                    'Lag': ['Lag-1 (daily)', 'Lag-5 (weekly)', 'Lag-20 (monthly)'],
-                    'Value': [acf_1, acf_5, acf_20],
-                    'Interpretation': [
-                        'Momentum' if float(acf_1) > 0.1 else 'Mean Reversion' if float(acf_1) < -0.1 else 'Random',
-                        'Momentum' if float(acf_5) > 0.1 else 'Mean Reversion' if float(acf_5) < -0.1 else 'Random',
-                        'Momentum' if float(acf_20) > 0.1 else 'Mean Reversion' if float(acf_20) < -0.1 else 'Random'
-                    ]
-                })
-                st.dataframe(acf_data, hide_index=True, width="stretch")
+                    interpretation = """
+                    **Random Walk Behavior**
+                    - H ≈ 0.5 indicates randomness
+                    - Past doesn't predict future
+                    - Technical analysis less effective
+                    """
             
-            # ===== RISK METRICS =====
-            st.header("⚠️ Risk Analysis")
-            
-            col1, col2, col3 = st.columns(3)
-            col1.metric("Sharpe Ratio", sharpe, "Risk-adjusted return")
-            col2.metric("Max Drawdown", f"{max_drawdown}%", "Worst drop")
-            col3.metric("Daily Volatility", f"{float(volatility)*100:.2f}%" if volatility != "N/A" else "N/A", "Price swings")
-            
-            # ===== RAW OUTPUT (OPTIONAL) =====
-            with st.expander("🔍 Detailed C++ Output"):
-                st.code(output, language='text')
\ No newline at end of file
+            st.info(interpretation or hurst_behavior)
+        
+        with tab3:
+            import pandas as pd
+            acf_data = pd.DataFrame({
+                'Lag': ['Lag-1 (daily)', 'Lag-5 (weekly)', 'Lag-20 (monthly)'],
+                'Value': [acf_1, acf_5, acf_20],
+                'Interpretation': [
+                    'Momentum' if float(acf_1) > 0.1 else 'Mean Reversion' if float(acf_1) < -0.1 else 'Random',
+                    'Momentum' if float(acf_5) > 0.1 else 'Mean Reversion' if float(acf_5) < -0.1 else 'Random',
+                    'Momentum' if float(acf_20) > 0.1 else 'Mean Reversion' if float(acf_20) < -0.1 else 'Random'
+                ]
+            })
+            st.dataframe(acf_data, hide_index=True, width="stretch")
+        
+        # ===== RISK METRICS =====
+        st.header("⚠️ Risk Analysis")
+        
+        col1, col2, col3 = st.columns(3)
+        col1.metric("Sharpe Ratio", sharpe, "Risk-adjusted return")
+        col2.metric("Max Drawdown", f"{max_drawdown}%", "Worst drop")
+        col3.metric("Daily Volatility", f"{float(volatility)*100:.2f}%" if volatility != "N/A" else "N/A", "Price swings")
+        
+        # ===== RAW OUTPUT (OPTIONAL) =====
+        with st.expander("🔍 Detailed C++ Output"):
+            st.code(metrics['raw'], language='json')
\ No newline at end of file
@@ -0,0 +1,105 @@
+"""Readers for the machine-readable outputs of the stocks binary.
+
+    stocks NVDA --format=json [--series]         -> read_json_reports(text)
+    stocks --universe data --format=bin --series -> read_bin_reports(data)
+
+The binary layout is documented in src/ReportFormat.h. Series columns are
+returned as numpy arrays viewing the input buffer (no copy) when numpy is
+available, else as lists.
+"""
+import json
+import math
+import struct
+
+try:
+    import numpy as np
+except ImportError:  # the decoder itself only needs struct
+    np = None
+
+MAGIC = b"SSRB"
+SERIES = 1
+FAILED = 2
+HEADER = struct.Struct("<4sHHIIiIII")
+SCALARS = ("latestClose", "sma20", "volatility20", "returnMean", "returnStddev",
+           "returnMax", "returnMin", "sharpe", "periodReturn", "maxDrawdown",
+           "bollingerMiddle", "bollingerUpper", "bollingerLower", "hurst", "signal")
+STRATEGY_FIELDS = ("totalReturn", "sharpe", "maxDrawdown", "winRate", "score")
+SERIES_COLUMNS = ("close", "volume", "return", "sma20", "volatility20",
+                  "bollingerMiddle", "bollingerUpper", "bollingerLower")
+
+
+def read_json_reports(text):
+    """One dict per non-empty line of --format=json output"""
+    return [json.loads(line) for line in text.splitlines() if line.strip()]
+
+
+def _doubles(buf, offset, count):
+    if np is not None:
+        return np.frombuffer(buf, dtype="<f8", count=count, offset=offset)
+    return list(struct.unpack_from(f"<{count}d", buf, offset))
+
+
+def _dates(buf, offset, count):
+    if np is not None:
+        return np.frombuffer(buf, dtype="<i4", count=count, offset=offset).astype("datetime64[D]")
+    return list(struct.unpack_from(f"<{count}i", buf, offset))
+
+
+def _nan_to_none(value):
+    return None if math.isnan(value) else value
+
+
+def read_bin_reports(data):
+    """Decode back-to-back --format=bin records into dicts"""
+    buf = memoryview(data)
+    reports = []
+    offset = 0
+    while offset < len(buf):
+        magic, version, flags, size, rows, latest, n_strategies, n_lags, n_scalars = \
+            HEADER.unpack_from(buf, offset)
+        if magic != MAGIC:
+            raise ValueError(f"bad record magic {magic!r} at byte {offset}")
+        if version != 1:
+            raise ValueError(f"unsupported record version {version}")
+
+        pos = offset + HEADER.size
+        scalars = struct.unpack_from(f"<{n_scalars}d", buf, pos)
+        pos += 8 * n_scalars
+        acf = struct.unpack_from(f"<{n_lags}d", buf, pos)
+        pos += 8 * n_lags
+        table = struct.unpack_from(f"<{5 * n_strategies}d", buf, pos)
+        pos += 40 * n_strategies
+
+        series = None
+        if flags & SERIES:
+            series = {"date": _dates(buf, pos, rows)}
+            pos += (4 * rows + 7) & ~7
+            for name in SERIES_COLUMNS:
+                series[name] = _doubles(buf, pos, rows)
+                pos += 8 * rows
+
+        strings = []
+        end = offset + size
+        while pos + 4 <= end and len(strings) < (2 if flags & FAILED else 6 + n_strategies):
+            (length,) = struct.unpack_from("<I", buf, pos)
+            strings.append(bytes(buf[pos + 4:pos + 4 + length]).decode())
+            pos += 4 + length
+
+        if flags & FAILED:
+            reports.append({"ticker": strings[0], "error": strings[1]})
+        else:
+            report = {"ticker": strings[0], "source": strings[1], "rows": rows,
+                      "latestDate": latest,
+                      "bollingerStatus": strings[2], "hurstBehavior": strings[3],
+                      "recommended": strings[4], "action": strings[5],
+                      "acfLags": [_nan_to_none(v) for v in acf],
+                      "strategies": [
+                          dict(name=strings[6 + i],
+                               **{f: _nan_to_none(table[5 * i + k]) for k, f in enumerate(STRATEGY_FIELDS)})
+                          for i in range(n_strategies)]}
+            report.update({name: _nan_to_none(v) for name, v in zip(SCALARS, scalars)})
+            if series is not None:
+                report["series"] = series
+            reports.append(report)
+        offset = end
+    return reports
@@ -0,0 +1,278 @@
+"""ctypes binding for libstocksense (src/stocksense_c.h).
+
+    from stocksense import StockSense
+    lib = StockSense()                      # src/libstocksense.so by default
+    with lib.analyze("NVDA") as a:
+        sma = a.column("sma")               # numpy view, no copy
+        print(a.summary()["action"], sma[-1])
+
+Arrays are read-only numpy views into memory owned by the C analysis
+handle. Each view holds a reference to that handle, so it is only freed
+once the Analysis is closed (or gone) and every array taken from it is gone
+too: `sma` above stays valid after the with block.
+
+Analysis.arrow() hands all columns to pyarrow through the Arrow C Data
+Interface, again without copying; the Arrow data keeps the underlying
+memory alive on its own, independent of close():
+
+    batch = a.arrow()                       # pyarrow.RecordBatch
+    frame = a.frame()                       # pandas; float columns stay zero-copy
+"""
+import ctypes
+import json
+import weakref
+from pathlib import Path
+
+import numpy as np
+
+ABI_VERSION = 1
+
+COLUMNS = {
+    "open": 0, "high": 1, "low": 2, "close": 3, "volume": 4, "return": 5,
+    "sma": 6, "volatility": 7, "bollinger_middle": 8, "bollinger_upper": 9,
+    "bollinger_lower": 10, "signal": 11,
+}
+
+DEFAULT_LIBRARY = Path(__file__).resolve().parent.parent / "src" / "libstocksense.so"
+
+
+class _Summary(ctypes.Structure):
+    _fields_ = [
+        ("struct_size", ctypes.c_uint32),
+        ("latest_date", ctypes.c_int32),
+        ("latest_close", ctypes.c_double),
+        ("sma20", ctypes.c_double),
+        ("volatility20", ctypes.c_double),
+        ("return_mean", ctypes.c_double),
+        ("return_stddev", ctypes.c_double),
+        ("return_max", ctypes.c_double),
+        ("return_min", ctypes.c_double),
+        ("sharpe", ctypes.c_double),
+        ("period_return", ctypes.c_double),
+        ("max_drawdown", ctypes.c_double),
+        ("bollinger_middle", ctypes.c_double),
+        ("bollinger_upper", ctypes.c_double),
+        ("bollinger_lower", ctypes.c_double),
+        ("hurst", ctypes.c_double),
+        ("signal", ctypes.c_double),
+        ("bollinger_status", ctypes.c_char_p),
+        ("hurst_behavior", ctypes.c_char_p),
+        ("recommended", ctypes.c_char_p),
+        ("action", ctypes.c_char_p),
+    ]
+
+
+class _Strategy(ctypes.Structure):
+    _fields_ = [
+        ("struct_size", ctypes.c_uint32),
+        ("name", ctypes.c_char_p),
+        ("total_return", ctypes.c_double),
+        ("sharpe", ctypes.c_double),
+        ("max_drawdown", ctypes.c_double),
+        ("win_rate", ctypes.c_double),
+        ("score", ctypes.c_double),
+    ]
+
+
+# Arrow C Data Interface structs (ss_export_arrow fills them, pyarrow moves
+# their contents out on import)
+class _ArrowSchema(ctypes.Structure):
+    _fields_ = [
+        ("format", ctypes.c_char_p),
+        ("name", ctypes.c_char_p),
+        ("metadata", ctypes.c_char_p),
+        ("flags", ctypes.c_int64),
+        ("n_children", ctypes.c_int64),
+        ("children", ctypes.c_void_p),
+        ("dictionary", ctypes.c_void_p),
+        ("release", ctypes.c_void_p),
+        ("private_data", ctypes.c_void_p),
+    ]
+
+
+class _ArrowArray(ctypes.Structure):
+    _fields_ = [
+        ("length", ctypes.c_int64),
+        ("null_count", ctypes.c_int64),
+        ("offset", ctypes.c_int64),
+        ("n_buffers", ctypes.c_int64),
+        ("n_children", ctypes.c_int64),
+        ("buffers", ctypes.c_void_p),
+        ("children", ctypes.c_void_p),
+        ("dictionary", ctypes.c_void_p),
+        ("release", ctypes.c_void_p),
+        ("private_data", ctypes.c_void_p),
+    ]
+
+
+class StockSenseError(RuntimeError):
+    pass
+
+
+class StockSense:
+    """The loaded library; analyses are created from it"""
+
+    def __init__(self, path=DEFAULT_LIBRARY):
+        lib = ctypes.CDLL(str(path))
+        handle = ctypes.c_void_p
+        dbl_p = ctypes.POINTER(ctypes.c_double)
+        for name, restype, argtypes in [
+            ("ss_abi_version", ctypes.c_int, []),
+            ("ss_last_error", ctypes.c_char_p, []),
+            ("ss_analyze_ticker", handle, [ctypes.c_char_p, ctypes.c_int]),
+            ("ss_analyze_series", handle, [ctypes.c_char_p, ctypes.c_size_t,
+                                           ctypes.POINTER(ctypes.c_int32), dbl_p, dbl_p, dbl_p,
+                                           dbl_p, dbl_p]),
+            ("ss_free", None, [handle]),
+            ("ss_ticker", ctypes.c_char_p, [handle]),
+            ("ss_source", ctypes.c_char_p, [handle]),
+            ("ss_rows", ctypes.c_size_t, [handle]),
+            ("ss_dates", ctypes.POINTER(ctypes.c_int32), [handle]),
+            ("ss_column", dbl_p, [handle, ctypes.c_int]),
+            ("ss_acf", dbl_p, [handle, ctypes.POINTER(ctypes.c_size_t)]),
+            ("ss_get_summary", ctypes.c_int, [handle, ctypes.POINTER(_Summary)]),
+            ("ss_strategy_count", ctypes.c_size_t, [handle]),
+            ("ss_get_strategy", ctypes.c_int, [handle, ctypes.c_size_t, ctypes.POINTER(_Strategy)]),
+            ("ss_report_json", ctypes.c_char_p, [handle, ctypes.c_int]),
+            ("ss_export_arrow", ctypes.c_int, [handle, ctypes.c_void_p, ctypes.c_void_p]),
+        ]:
+            fn = getattr(lib, name)
+            fn.restype = restype
+            fn.argtypes = argtypes
+        if lib.ss_abi_version() != ABI_VERSION:
+            raise StockSenseError(f"{path} has ABI {lib.ss_abi_version()}, expected {ABI_VERSION}")
+        self._lib = lib
+
+    def error(self):
+        return self._lib.ss_last_error().decode()
+
+    def analyze(self, ticker, allow_fetch=True):
+        """Load and analyze a ticker symbol or CSV path"""
+        handle = self._lib.ss_analyze_ticker(str(ticker).encode(), int(allow_fetch))
+        if not handle:
+            raise StockSenseError(self.error())
+        return Analysis(self, handle)
+
+    def analyze_series(self, dates, close, open=None, high=None, low=None, volume=None, ticker=""):
+        """Analyze in-memory bars; dates are datetime64[D] or days since 1970-01-01"""
+        dates = np.ascontiguousarray(np.asarray(dates).astype("datetime64[D]").astype(np.int32))
+        columns = [None if c is None else np.ascontiguousarray(c, dtype=np.float64)
+                   for c in (open, high, low, close, volume)]
+        if any(c is not None and len(c) != len(dates) for c in columns):
+            raise ValueError("every column needs one value per date")
+        ptrs = [None if c is None else c.ctypes.data_as(ctypes.POINTER(ctypes.c_double))
+                for c in columns]
+        handle = self._lib.ss_analyze_series(ticker.encode(), len(dates),
+                                             dates.ctypes.data_as(ctypes.POINTER(ctypes.c_int32)),
+                                             *ptrs)
+        if not handle:
+            raise StockSenseError(self.error())
+        return Analysis(self, handle)
+
+
+class _Handle:
+    """Owns one C analysis handle. The Analysis and every view taken from it
+    reference this object; ss_free runs when the last of them lets go."""
+
+    def __init__(self, lib, value):
+        self.value = value
+        weakref.finalize(self, lib.ss_free, value)
+
+
+class Analysis:
+    """One analysis handle. Arrays and strings are borrowed from it."""
+
+    def __init__(self, sense, handle):
+        self._lib = sense._lib
+        self._handle = _Handle(self._lib, handle)
+        self.rows = self._lib.ss_rows(handle)
+        self.ticker = self._lib.ss_ticker(handle).decode()
+        self.source = self._lib.ss_source(handle).decode()
+
+    def close(self):
+        """Release this object's reference; the handle is freed now, or once
+        the last array taken from it is gone"""
+        self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _check(self):
+        if self._handle is None:
+            raise StockSenseError("analysis is closed")
+        return self._handle.value
+
+    def _view(self, pointer, count, ctype, dtype):
+        # The ctypes array holds a reference to the handle and is the numpy
+        # array's base, so the handle outlives every view of it, even past
+        # close()
+        buffer = (ctype * count).from_address(ctypes.addressof(pointer.contents))
+        buffer._owner = self._handle
+        view = np.frombuffer(buffer, dtype=dtype, count=count)
+        view.flags.writeable = False
+        return view
+
+    def column(self, name):
+        pointer = self._lib.ss_column(self._check(), COLUMNS[name])
+        if not pointer:
+            raise StockSenseError(self._lib.ss_last_error().decode())
+        return self._view(pointer, self.rows, ctypes.c_double, np.float64)
+
+    def dates(self):
+        """Bar dates as datetime64[D] (a copy; the int32 days are at dates_raw())"""
+        return self.dates_raw().astype("datetime64[D]")
+
+    def dates_raw(self):
+        return self._view(self._lib.ss_dates(self._check()), self.rows, ctypes.c_int32, np.int32)
+
+    def acf(self):
+        lags = ctypes.c_size_t(0)
+        pointer = self._lib.ss_acf(self._check(), ctypes.byref(lags))
+        if lags.value == 0:
+            return np.empty(0)
+        return self._view(pointer, lags.value, ctypes.c_double, np.float64)
+
+    def summary(self):
+        s = _Summary(struct_size=ctypes.sizeof(_Summary))
+        if self._lib.ss_get_summary(self._check(), ctypes.byref(s)) != 0:
+            raise StockSenseError(self._lib.ss_last_error().decode())
+        out = {name: getattr(s, name) for name, _ in _Summary._fields_[1:]}
+        for key in ("bollinger_status", "hurst_behavior", "recommended", "action"):
+            out[key] = out[key].decode()
+        return out
+
+    def strategies(self):
+        """Backtest table, best first"""
+        table = []
+        handle = self._check()
+        for rank in range(self._lib.ss_strategy_count(handle)):
+            s = _Strategy(struct_size=ctypes.sizeof(_Strategy))
+            self._lib.ss_get_strategy(handle, rank, ctypes.byref(s))
+            row = {name: getattr(s, name) for name, _ in _Strategy._fields_[1:]}
+            row["name"] = row["name"].decode()
+            table.append(row)
+        return table
+
+    def report(self, include_series=False):
+        """The `stocks --format=json` report as a dict"""
+        return json.loads(self._lib.ss_report_json(self._check(), int(include_series)))
+
+    def arrow(self):
+        """Every per-bar column as a pyarrow.RecordBatch, zero-copy"""
+        import pyarrow as pa
+
+        schema = _ArrowSchema()
+        array = _ArrowArray()
+        if self._lib.ss_export_arrow(self._check(), ctypes.addressof(schema),
+                                     ctypes.addressof(array)) != 0:
+            raise StockSenseError(self._lib.ss_last_error().decode())
+        # Importing moves both structs into pyarrow, which calls release
+        return pa.RecordBatch._import_from_c(ctypes.addressof(array), ctypes.addressof(schema))
+
+    def frame(self):
+        """arrow() as a pandas DataFrame. split_blocks keeps each float column
+        a view of the exported buffer instead of consolidating (copying) them."""
+        return self.arrow().to_pandas(split_blocks=True)
@@ -0,0 +1,257 @@
+#include "AnalysisServer.h"
+#include "JsonWriter.h"
+#include "UnixSocket.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t gSignalled = 0;
+
+void OnSignal(int) { gSignalled = 1; }
+
+std::string ErrorJson(const std::string& message) {
+    JsonWriter json;
+    json.BeginObject().Key("ok").Bool(false).Key("error").String(message).EndObject();
+    return json.Take();
+}
+
+} // namespace
+
+AnalysisServer::AnalysisServer(std::string socketPath)
+    : socketPath_(std::move(socketPath)), started_(std::chrono::steady_clock::now()) {}
+
+AnalysisServer::~AnalysisServer() {
+    Stop();
+    std::unique_lock<std::mutex> lock(clientsMutex_);
+    for (int fd : clients_) ::shutdown(fd, SHUT_RDWR);
+    clientsDone_.wait(lock, [this] { return activeClients_ == 0; });
+}
+
+bool AnalysisServer::Stamp(const std::string& path, FileStamp& stamp) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return false;
+    stamp.size = static_cast<uintmax_t>(st.st_size);
+    stamp.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// ------------------- Requests -------------------
+
+std::string AnalysisServer::Handle(const std::string& request) {
+    ++requests_;
+    size_t begin = request.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return ErrorJson("empty request");
+    size_t end = request.find_last_not_of(" \t\r");
+    std::string line = request.substr(begin, end - begin + 1);
+
+    size_t space = line.find(' ');
+    std::string command = line.substr(0, space);
+    std::string argument;
+    if (space != std::string::npos) {
+        size_t from = line.find_first_not_of(' ', space);
+        if (from != std::string::npos) argument = line.substr(from);
+    }
+
+    if (command == "analyze") {
+        if (argument.empty()) return ErrorJson("usage: analyze <ticker>");
+        return Analyze(argument);
+    }
+    if (command == "invalidate") return Invalidate(argument);
+    if (command == "stats") return Stats();
+    if (command == "ping") {
+        JsonWriter json;
+        json.BeginObject().Key("ok").Bool(true).Key("pong").Bool(true).EndObject();
+        return json.Take();
+    }
+    return ErrorJson("unknown command '" + command + "'");
+}
+
+std::string AnalysisServer::Analyze(const std::string& ticker) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Where the cached entry came from (or, for a new ticker, where it would
+    // load from). Stat it outside the lock; a change shows up as a new stamp.
+    std::string path;
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache_.find(ticker);
+        if (it != cache_.end()) {
+            path = it->second.sourcePath;
+            known = true;
+        }
+    }
+    if (!known) path = loader_.FindTickerCSV(ticker);
+    FileStamp stamp;
+    if (!path.empty() && !Stamp(path, stamp)) {
+        // The file went away; look again from scratch
+        path = loader_.FindTickerCSV(ticker);
+        stamp = FileStamp();
+        if (!path.empty()) Stamp(path, stamp);
+    }
+
+    SharedAnalysis shared;
+    std::promise<std::shared_ptr<const CachedAnalysis>> promise;
+    bool owner = false;
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache_.find(ticker);
+        if (it != cache_.end() && it->second.sourcePath == path && it->second.stamp == stamp) {
+            shared = it->second.analysis;
+        } else {
+            if (it != cache_.end()) ++invalidations_;
+            owner = true;
+            id = ++nextId_;
+            shared = promise.get_future().share();
+            cache_[ticker] = Entry{ shared, path, stamp, id };
+        }
+    }
+    ++(owner ? misses_ : hits_);
+
+    if (owner) {
+        auto result = std::make_shared<CachedAnalysis>();
+        try {
+            TickerAnalysis analysis = AnalyzeTicker(loader_, ticker);
+            if (analysis.load.status == LoadStatus::Ok && !analysis.load.series.empty()) {
+                result->ok = true;
+                result->json = AnalysisJson(analysis);
+            } else {
+                result->json = analysis.load.error.empty() ? "no data for " + ticker : analysis.load.error;
+            }
+        } catch (const std::exception& e) {
+            result->json = e.what();
+        }
+        promise.set_value(result);
+
+        // Failures are answered but not kept, so the next request retries
+        if (!result->ok) {
+            std::lock_guard<std::mutex> lock(cacheMutex_);
+            auto it = cache_.find(ticker);
+            if (it != cache_.end() && it->second.id == id) cache_.erase(it);
+        }
+    }
+
+    std::shared_ptr<const CachedAnalysis> analysis = shared.get();
+    if (!analysis->ok) return ErrorJson(analysis->json);
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    JsonWriter json;
+    json.BeginObject()
+        .Key("ok").Bool(true)
+        .Key("cached").Bool(!owner)
+        .Key("elapsedMs").Number(elapsedMs)
+        .Key("analysis").Raw(analysis->json)
+        .EndObject();
+    return json.Take();
+}
+
+std::string AnalysisServer::Invalidate(const std::string& ticker) {
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        if (ticker.empty() || ticker == "*") {
+            dropped = cache_.size();
+            cache_.clear();
+        } else {
+            dropped = cache_.erase(ticker);
+        }
+    }
+    invalidations_ += dropped;
+    JsonWriter json;
+    json.BeginObject().Key("ok").Bool(true).Key("dropped").Int(static_cast<long long>(dropped)).EndObject();
+    return json.Take();
+}
+
+std::string AnalysisServer::Stats() {
+    size_t entries;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        entries = cache_.size();
+    }
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    JsonWriter json;
+    json.BeginObject()
+        .Key("ok").Bool(true)
+        .Key("entries").Int(static_cast<long long>(entries))
+        .Key("requests").Int(static_cast<long long>(requests_.load()))
+        .Key("hits").Int(static_cast<long long>(hits_.load()))
+        .Key("misses").Int(static_cast<long long>(misses_.load()))
+        .Key("invalidations").Int(static_cast<long long>(invalidations_.load()))
+        .Key("uptimeSec").Number(uptime)
+        .EndObject();
+    return json.Take();
+}
+
+// ------------------- Socket -------------------
+
+void AnalysisServer::Serve(int client) {
+    std::string pending;
+    char buf[4096];
+    bool open = true;
+    while (open) {
+        ssize_t n = ::recv(client, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pending.append(buf, static_cast<size_t>(n));
+        if (pending.size() > 65536 && pending.find('\n') == std::string::npos) {
+            SendAll(client, ErrorJson("request line too long") + "\n");
+            break;
+        }
+
+        size_t newline;
+        while (open && (newline = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (line == "quit" || line == "quit\r") {
+                open = false;
+                break;
+            }
+            open = SendAll(client, Handle(line) + "\n");
+        }
+    }
+
+    // Leave clients_ before closing: once closed, the fd number can be
+    // reused by another thread, and the destructor must not shut that down
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    clients_.erase(std::find(clients_.begin(), clients_.end(), client));
+    ::close(client);
+    --activeClients_;
+    clientsDone_.notify_all();
+}
+
+int AnalysisServer::Run() {
+    int listener = ListenUnixSocket(socketPath_, error_);
+    if (listener < 0) return 1;
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    // Poll with a timeout so Stop() and signals are noticed promptly
+    pollfd pfd{ listener, POLLIN, 0 };
+    while (!stopping_ && !gSignalled) {
+        int ready = ::poll(&pfd, 1, 250);
+        if (ready <= 0) continue;
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) continue;
+
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex_);
+            clients_.push_back(client);
+            ++activeClients_;
+        }
+        std::thread([this, client] { Serve(client); }).detach();
+    }
+
+    ::close(listener);
+    RemoveUnixSocket(socketPath_);
+    return 0;
+}
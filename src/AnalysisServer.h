@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "StockDataLoader.h"
+#include "Universe.h"
+
+// Long-running analysis daemon behind `stocks --serve`.
+//
+// Listens on a Unix domain socket and answers one request per line with one
+// JSON object per line:
+//
+//   analyze <ticker>      -> {"ok":true,"cached":...,"elapsedMs":...,"analysis":{...}}
+//   invalidate [<ticker>] -> drop one cached ticker, or all of them
+//   stats                 -> cache size and hit/miss counters
+//   ping                  -> {"ok":true,"pong":true}
+//
+// Failures answer {"ok":false,"error":"..."}. Each connection is served by
+// its own thread and may send any number of requests.
+//
+// Analyses stay resident, keyed by ticker, with the JSON already rendered,
+// so a repeated request costs a hash lookup and a stat() of the source CSV.
+// When that CSV's size or modification time changes the entry is rebuilt.
+// Concurrent requests for a ticker that is still being analyzed wait on the
+// same shared_future instead of analyzing it again.
+class AnalysisServer {
+public:
+    explicit AnalysisServer(std::string socketPath);
+    ~AnalysisServer();
+
+    AnalysisServer(const AnalysisServer&) = delete;
+    AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+    // Bind and serve until Stop() (or SIGINT / SIGTERM). Returns 0 on a clean
+    // shutdown, 1 if the socket could not be set up (error() says why).
+    int Run();
+
+    // Ask Run() to return; safe from any thread
+    void Stop() { stopping_ = true; }
+
+    // Answer one request line (without the newline). Used by the connection
+    // threads; exposed so the protocol can be exercised without a socket.
+    std::string Handle(const std::string& request);
+
+    const std::string& error() const { return error_; }
+
+private:
+    // Source file identity; a change in either field invalidates the entry
+    struct FileStamp {
+        uintmax_t size = 0;
+        int64_t mtime = 0;
+        bool operator==(const FileStamp& o) const { return size == o.size && mtime == o.mtime; }
+    };
+
+    struct CachedAnalysis {
+        bool ok = false;
+        std::string json;          // "analysis" object, or the error message when !ok
+    };
+    using SharedAnalysis = std::shared_future<std::shared_ptr<const CachedAnalysis>>;
+
+    struct Entry {
+        SharedAnalysis analysis;
+        std::string sourcePath;    // local CSV ("" for downloads, which never go stale)
+        FileStamp stamp;
+        uint64_t id = 0;           // distinguishes rebuilds of the same ticker
+    };
+
+    std::string Analyze(const std::string& ticker);
+    std::string Invalidate(const std::string& ticker);
+    std::string Stats();
+    void Serve(int client);
+
+    static bool Stamp(const std::string& path, FileStamp& stamp);
+
+    std::string socketPath_;
+    std::string error_;
+    std::atomic<bool> stopping_{false};
+    StockDataLoader loader_;
+
+    std::mutex cacheMutex_;
+    std::unordered_map<std::string, Entry> cache_;
+    uint64_t nextId_ = 0;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> invalidations_{0};
+    std::chrono::steady_clock::time_point started_;
+
+    // Open connections; the destructor shuts them down and waits for their
+    // (detached) threads to finish
+    std::mutex clientsMutex_;
+    std::condition_variable clientsDone_;
+    std::vector<int> clients_;
+    size_t activeClients_ = 0;
+};
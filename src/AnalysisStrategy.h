@@ -1,14 +1,47 @@
 #pragma once
 #include <vector>
 #include <string>
-#include "StockData.h"
+#include "PriceSeries.h"
+#include "BacktestKernel.h"
 
 // Abstract base class (interface) for analysis strategies
 class AnalysisStrategy {
 public:
     virtual ~AnalysisStrategy() = default;
     
-    virtual double analyze(const std::vector<StockData>& data) = 0;
+    virtual double analyze(const PriceSeries& data) = 0;
+
+    // Point-in-time signal for every bar: element i is what analyze() returns
+    // when given bars [0, i] only. The default does exactly that, which costs
+    // O(n^2); strategies should override it with a single causal pass.
+    virtual std::vector<double> analyzeSeries(const PriceSeries& data) {
+        std::vector<double> signals(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            signals[i] = analyze(data.Slice(0, i + 1));
+        }
+        return signals;
+    }
+    
+    // How backtests turn this strategy's signals into positions. By default
+    // a signal beyond +/-5 goes long/short for the next bar.
+    virtual PositionRule positionRule() const { return PositionRule(); }
+    
+    // Backtest the whole of data: analyzeSeries() signals through
+    // positionRule(). A strategy may override this with a fused kernel (see
+    // StaticStrategy.h); subclasses of such a strategy that change
+    // analyzeSeries() or positionRule() must override it as well.
+    virtual BacktestResult backtest(const PriceSeries& data) {
+        std::vector<double> signals = analyzeSeries(data);
+        return RunBacktest(data.Close(), signals.data(), positionRule());
+    }
     
     virtual std::string getName() const = 0;
+
+    // Name plus every parameter that affects the signals, e.g.
+    // "Momentum/Trending Strategy(50,5)". Two strategies with the same
+    // identity must backtest identically, which lets StrategySelector reuse
+    // results across strategy objects. Empty (the default) means never reuse.
+    // Like backtest(), subclasses of a built-in strategy that change its
+    // signals must override it.
+    virtual std::string cacheIdentity() const { return std::string(); }
 };
\ No newline at end of file
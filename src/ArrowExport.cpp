@@ -0,0 +1,163 @@
+#include "ArrowExport.h"
+#include <utility>
+
+namespace {
+
+// ------------------- Schema -------------------
+
+struct ColumnSchemaData {
+    std::string name;
+    std::string format;
+};
+
+struct TableSchemaData {
+    std::vector<ArrowSchema> children;     // sized once; addresses are stable
+    std::vector<ArrowSchema*> childPointers;
+};
+
+void ReleaseColumnSchema(ArrowSchema* schema) {
+    delete static_cast<ColumnSchemaData*>(schema->private_data);
+    schema->release = nullptr;
+}
+
+void ReleaseTableSchema(ArrowSchema* schema) {
+    auto data = static_cast<TableSchemaData*>(schema->private_data);
+    // A child the consumer moved out has release == nullptr and is theirs now
+    for (ArrowSchema& child : data->children) {
+        if (child.release != nullptr) child.release(&child);
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+// ------------------- Array -------------------
+
+// Every array keeps its own reference to the owner, so a child moved out of
+// the table stays valid after the table itself is released
+struct ColumnArrayData {
+    std::shared_ptr<const void> owner;
+    const void* buffers[2];                // validity (none), values
+};
+
+struct TableArrayData {
+    std::shared_ptr<const void> owner;
+    const void* buffers[1] = { nullptr };  // validity (none)
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> childPointers;
+};
+
+void ReleaseColumnArray(ArrowArray* array) {
+    delete static_cast<ColumnArrayData*>(array->private_data);
+    array->release = nullptr;
+}
+
+void ReleaseTableArray(ArrowArray* array) {
+    auto data = static_cast<TableArrayData*>(array->private_data);
+    for (ArrowArray& child : data->children) {
+        if (child.release != nullptr) child.release(&child);
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+} // namespace
+
+void ExportArrowTable(std::shared_ptr<const void> owner, size_t rows,
+                      const std::vector<ArrowExportColumn>& columns,
+                      ArrowSchema* schema, ArrowArray* array) {
+    const size_t n = columns.size();
+
+    auto schemaData = new TableSchemaData();
+    schemaData->children.resize(n);
+    auto arrayData = new TableArrayData();
+    arrayData->owner = owner;
+    arrayData->children.resize(n);
+
+    for (size_t c = 0; c < n; ++c) {
+        auto columnSchema = new ColumnSchemaData{ columns[c].name, columns[c].format };
+        ArrowSchema& s = schemaData->children[c];
+        s.format = columnSchema->format.c_str();
+        s.name = columnSchema->name.c_str();
+        s.metadata = nullptr;
+        s.flags = 0;  // no nulls are ever exported; missing values are NaN
+        s.n_children = 0;
+        s.children = nullptr;
+        s.dictionary = nullptr;
+        s.release = ReleaseColumnSchema;
+        s.private_data = columnSchema;
+        schemaData->childPointers.push_back(&s);
+
+        auto columnArray = new ColumnArrayData{ owner, { nullptr, columns[c].data } };
+        ArrowArray& a = arrayData->children[c];
+        a.length = static_cast<int64_t>(rows);
+        a.null_count = 0;
+        a.offset = 0;
+        a.n_buffers = 2;
+        a.n_children = 0;
+        a.buffers = columnArray->buffers;
+        a.children = nullptr;
+        a.dictionary = nullptr;
+        a.release = ReleaseColumnArray;
+        a.private_data = columnArray;
+        arrayData->childPointers.push_back(&a);
+    }
+
+    schema->format = "+s";
+    schema->name = "";
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = static_cast<int64_t>(n);
+    schema->children = schemaData->childPointers.data();
+    schema->dictionary = nullptr;
+    schema->release = ReleaseTableSchema;
+    schema->private_data = schemaData;
+
+    array->length = static_cast<int64_t>(rows);
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = 1;
+    array->n_children = static_cast<int64_t>(n);
+    array->buffers = arrayData->buffers;
+    array->children = arrayData->childPointers.data();
+    array->dictionary = nullptr;
+    array->release = ReleaseTableArray;
+    array->private_data = arrayData;
+}
+
+void ExportPriceSeries(const PriceSeries& data, ArrowSchema* schema, ArrowArray* array) {
+    auto owner = std::make_shared<const PriceSeries>(data);
+    std::vector<ArrowExportColumn> columns = {
+        { "date", "tdD", owner->Dates().data() },
+        { "open", "g", owner->Open().data() },
+        { "high", "g", owner->High().data() },
+        { "low", "g", owner->Low().data() },
+        { "close", "g", owner->Close().data() },
+        { "volume", "g", owner->Volume().data() },
+    };
+    ExportArrowTable(owner, owner->size(), columns, schema, array);
+}
+
+std::vector<ArrowExportColumn> AnalysisArrowColumns(const TickerAnalysis& analysis,
+                                                    const std::vector<double>* signals) {
+    const PriceSeries& data = analysis.load.series;
+    const IndicatorResults& ind = analysis.indicators;
+    std::vector<ArrowExportColumn> columns = {
+        { "date", "tdD", data.Dates().data() },
+        { "open", "g", data.Open().data() },
+        { "high", "g", data.High().data() },
+        { "low", "g", data.Low().data() },
+        { "close", "g", data.Close().data() },
+        { "volume", "g", data.Volume().data() },
+    };
+    auto add = [&](const char* name, const std::vector<double>& values) {
+        if (values.size() == data.size()) columns.push_back({ name, "g", values.data() });
+    };
+    add("return", ind.returns);
+    add("sma20", ind.sma);
+    add("volatility20", ind.volatility);
+    add("bollinger_middle", ind.bollingerMiddle);
+    add("bollinger_upper", ind.bollingerUpper);
+    add("bollinger_lower", ind.bollingerLower);
+    if (signals != nullptr) add("signal", *signals);
+    return columns;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PriceSeries.h"
+#include "Universe.h"
+
+// Zero-copy export of columns through the Arrow C Data Interface
+// (https://arrow.apache.org/docs/format/CDataInterface.html), so pyarrow,
+// pandas, polars or DuckDB can import series and indicator tables without
+// a copy and without this code depending on Arrow.
+//
+// A table is exported as a struct array (one row per bar) whose children
+// are the columns. The children's value buffers point straight at the
+// existing column memory; the exported structs only hold a reference to
+// whatever owns it, dropped when the consumer calls release. Columns are
+// float64 ("g") or date32 ("tdD", the same int32 days since 1970-01-01 the
+// series stores). No validity bitmaps are exported: a missing indicator value
+// (an SMA before its window fills) is NaN, which pandas reads as missing.
+
+// The interface's ABI-stable structs, verbatim from the specification. The
+// guard lets them coexist with other copies (Arrow's own headers,
+// stocksense_c.h).
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+// One exported column: rows values of the given format at data
+struct ArrowExportColumn {
+    std::string name;
+    const char* format;   // "g" (double) or "tdD" (int32 days)
+    const void* data;
+};
+
+// Export columns, each rows long, as one struct array. owner must keep every
+// column's memory alive and unchanged; the exported structs share it until
+// their release callbacks have run (children moved out by the consumer keep
+// it on their own). On return both structs belong to the caller, who must
+// release them (in either order).
+void ExportArrowTable(std::shared_ptr<const void> owner, size_t rows,
+                      const std::vector<ArrowExportColumn>& columns,
+                      ArrowSchema* schema, ArrowArray* array);
+
+// date, open, high, low, close, volume of data. The exported table holds a
+// copy of the series, which shares (and so keeps) its column storage.
+void ExportPriceSeries(const PriceSeries& data, ArrowSchema* schema, ArrowArray* array);
+
+// Columns of an analysis: date, OHLCV, then return, sma20, volatility20,
+// bollinger_middle/upper/lower, and signal when signals is given (one per
+// bar). Indicators that were not computed are left out. Pointers refer to
+// analysis and signals, which the caller must keep alive (pass them in the
+// ExportArrowTable owner).
+std::vector<ArrowExportColumn> AnalysisArrowColumns(const TickerAnalysis& analysis,
+                                                    const std::vector<double>* signals = nullptr);
@@ -0,0 +1,91 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include "PriceSeries.h"
+
+// How a strategy's signal becomes a position held over the next bar
+struct PositionRule {
+    double threshold = 5.0;   // |signal| must exceed this to trade; NaN stays flat
+    bool alwaysLong = false;  // ignore the signal and stay fully invested
+
+    static PositionRule Threshold(double threshold) { return { threshold, false }; }
+    static PositionRule AlwaysLong() { return { 0.0, true }; }
+
+    // +1 long, -1 short, 0 flat
+    double PositionFor(double signal) const {
+        if (alwaysLong) return 1.0;
+        return std::fabs(signal) > threshold ? std::copysign(1.0, signal) : 0.0;
+    }
+};
+
+// Performance of holding positions[i] from close[i] to close[i+1]
+struct BacktestResult {
+    double totalReturn;  // compounded: final equity - 1
+    double sharpeRatio;  // mean / population stddev of in-market returns (NaN if stddev is 0)
+    double maxDrawdown;  // worst drop of the equity curve from its peak, <= 0
+    double winRate;      // fraction of in-market bars with a positive return
+    double turnover;     // sum of |position change| per bar
+    int trades;          // bars spent in the market
+};
+
+// Single pass over a price column and a per-bar position source. Flat bars
+// leave the equity unchanged and are not counted as trades; the equity curve
+// starts at 1.0 before the first bar. Nothing is allocated.
+template <typename PositionAt>
+BacktestResult RunBacktestWith(const PriceColumn& close, PositionAt positionAt) {
+    const size_t n = close.size();
+    double equity = 1.0;
+    double peak = 1.0;
+    double maxDrawdown = 0.0;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double turnover = 0.0;
+    double prevPosition = 0.0;
+    int trades = 0;
+    int wins = 0;
+
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const double position = positionAt(i);
+        const double nextReturn = (close[i + 1] - close[i]) / close[i];
+        const double r = position != 0.0 ? position * nextReturn : 0.0;
+
+        trades += position != 0.0;
+        wins += r > 0.0;
+        sum += r;
+        sumSq += r * r;
+        turnover += std::fabs(position - prevPosition);
+        prevPosition = position;
+
+        equity *= 1.0 + r;
+        peak = std::fmax(peak, equity);
+        maxDrawdown = std::fmin(maxDrawdown, (equity - peak) / peak);
+    }
+
+    BacktestResult result = { 0.0, 0.0, 0.0, 0.0, turnover, trades };
+    if (trades == 0) {
+        return result;
+    }
+
+    double mean = sum / trades;
+    double variance = (sumSq / trades) - (mean * mean);
+    if (variance < 0.0) variance = 0.0;
+    double stddev = std::sqrt(variance);
+
+    result.totalReturn = equity - 1.0;
+    result.sharpeRatio = stddev == 0.0 ? std::numeric_limits<double>::quiet_NaN() : mean / stddev;
+    result.maxDrawdown = maxDrawdown;
+    result.winRate = static_cast<double>(wins) / trades;
+    return result;
+}
+
+// Backtest from raw signals (e.g. AnalysisStrategy::analyzeSeries), turning
+// each into a position with rule. signals must hold close.size() values.
+inline BacktestResult RunBacktest(const PriceColumn& close, const double* signals,
+                                  const PositionRule& rule) {
+    return RunBacktestWith(close, [&](size_t i) { return rule.PositionFor(signals[i]); });
+}
+
+// Backtest from explicit positions (one per bar, any size; 0 = flat)
+inline BacktestResult RunBacktest(const PriceColumn& close, const double* positions) {
+    return RunBacktestWith(close, [&](size_t i) { return positions[i]; });
+}
@@ -8,7 +8,7 @@ private:
     StockAnalytics analytics;
     
 public:
-    double analyze(const std::vector<StockData>& data) override {
+    double analyze(const PriceSeries& data) override {
         // Buy and hold doesn't actively trade based on signals, just holds the position regardless of market conditions
         // Return a constant positive signal indicating "stay invested"
         
@@ -21,7 +21,18 @@ public:
         return 5.0;
     }
     
+    std::vector<double> analyzeSeries(const PriceSeries& data) override {
+        return std::vector<double>(data.size(), 5.0);
+    }
+    
+    // Always invested, whatever the signal says
+    PositionRule positionRule() const override {
+        return PositionRule::AlwaysLong();
+    }
+    
     std::string getName() const override {
         return "Buy & Hold Strategy";
     }
+
+    std::string cacheIdentity() const override { return getName(); }
 };
@@ -0,0 +1,71 @@
+#include "Fft.h"
+#include <cmath>
+#include <utility>
+
+size_t NextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+void Fft(std::vector<std::complex<double>>& data, bool inverse) {
+    const size_t n = data.size();
+    if (n <= 1) return;
+
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    // Butterflies; twiddles for each stage come from one sincos per stage
+    const double sign = inverse ? 1.0 : -1.0;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const double angle = sign * 2.0 * M_PI / static_cast<double>(len);
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        const size_t half = len / 2;
+
+        for (size_t start = 0; start < n; start += len) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> u = data[start + k];
+                std::complex<double> v = data[start + k + half] * w;
+                data[start + k] = u + v;
+                data[start + k + half] = u - v;
+                // Recompute periodically instead of compounding rounding error
+                w = ((k + 1) % 64 == 0)
+                    ? std::polar(1.0, angle * static_cast<double>(k + 1))
+                    : w * step;
+            }
+        }
+    }
+
+    if (inverse) {
+        const double scale = 1.0 / static_cast<double>(n);
+        for (auto& x : data) x *= scale;
+    }
+}
+
+void FftTwoReal(const double* a, const double* b, size_t n, size_t fftSize,
+                std::vector<std::complex<double>>& A,
+                std::vector<std::complex<double>>& B) {
+    // Pack z = a + i*b, transform once, then split using conjugate symmetry:
+    //   A[f] = (Z[f] + conj(Z[N-f])) / 2
+    //   B[f] = (Z[f] - conj(Z[N-f])) / 2i
+    std::vector<std::complex<double>> z(fftSize);
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = std::complex<double>(a[i], b ? b[i] : 0.0);
+    }
+    Fft(z);
+
+    A.resize(fftSize);
+    B.resize(fftSize);
+    for (size_t f = 0; f < fftSize; ++f) {
+        std::complex<double> zf = z[f];
+        std::complex<double> zc = std::conj(z[(fftSize - f) & (fftSize - 1)]);
+        A[f] = 0.5 * (zf + zc);
+        B[f] = std::complex<double>(0.0, -0.5) * (zf - zc);
+    }
+}
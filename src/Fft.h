@@ -0,0 +1,21 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Minimal self-contained FFT used by the analytics (no external dependency).
+
+// Smallest power of two >= n
+size_t NextPowerOfTwo(size_t n);
+
+// In-place iterative radix-2 FFT. data.size() must be a power of two.
+// The inverse transform is scaled by 1/N, so Fft(Fft(x), true) == x.
+void Fft(std::vector<std::complex<double>>& data, bool inverse = false);
+
+// Transform two real sequences with a single complex FFT of size fftSize.
+// a and b are zero-padded from length n; on return A and B hold their full
+// spectra (fftSize bins each). b may be nullptr to transform a alone.
+// fftSize must be a power of two >= n.
+void FftTwoReal(const double* a, const double* b, size_t n, size_t fftSize,
+                std::vector<std::complex<double>>& A,
+                std::vector<std::complex<double>>& B);
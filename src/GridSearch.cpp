@@ -0,0 +1,153 @@
+#include "GridSearch.h"
+#include "BacktestKernel.h"
+#include "BuyAndHoldStrategy.h"
+#include "MeanReversionStrategy.h"
+#include "OnlineIndicators.h"
+#include "ThreadPool.h"
+#include "TrendingStrategy.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Same signals as the strategies' analyzeSeries, from one bar's indicators
+double SignalPosition(const GridPoint& point, double price, double sma, double vol) {
+    double signal = kNaN;
+    switch (point.strategy) {
+    case GridStrategy::Trending:
+        signal = (price - sma) / sma * 100.0;
+        break;
+    case GridStrategy::MeanReversion: {
+        double zScore = (price - sma) / (vol * sma);
+        signal = -zScore * 100.0;
+        break;
+    }
+    case GridStrategy::BuyAndHold:
+        return PositionRule::AlwaysLong().PositionFor(signal);
+    }
+    return PositionRule::Threshold(point.threshold).PositionFor(signal);
+}
+
+} // namespace
+
+// ------------------- PrefixIndicators -------------------
+
+PrefixIndicators::PrefixIndicators(const PriceSeries& data)
+    : data_(data), close_(data.Close()) {
+    const size_t n = close_.size();
+    base_ = n > 0 ? close_[0] : 0.0;
+    closeSum_.assign(n + 1, 0.0);
+    retSum_.assign(n + 1, 0.0);
+    retSumSq_.assign(n + 1, 0.0);
+    retCount_.assign(n + 1, 0);
+
+    // Centring on the first close keeps the running sums small, so window
+    // differences lose less precision on long, high-priced series
+    for (size_t i = 0; i < n; ++i) {
+        closeSum_[i + 1] = closeSum_[i] + (close_[i] - base_);
+
+        double r = (i > 0 && close_[i - 1] != 0.0) ? (close_[i] - close_[i - 1]) / close_[i - 1] : kNaN;
+        bool valid = !std::isnan(r);
+        retSum_[i + 1] = retSum_[i] + (valid ? r : 0.0);
+        retSumSq_[i + 1] = retSumSq_[i] + (valid ? r * r : 0.0);
+        retCount_[i + 1] = retCount_[i] + valid;
+    }
+}
+
+double PrefixIndicators::Sma(size_t i, int window, size_t origin) const {
+    if (window <= 0 || i + 1 < origin + static_cast<size_t>(window)) return kNaN;
+    return base_ + (closeSum_[i + 1] - closeSum_[i + 1 - window]) / window;
+}
+
+double PrefixIndicators::Volatility(size_t i, int window, size_t origin) const {
+    if (window <= 0 || i < origin + static_cast<size_t>(window)) return kNaN;
+    const size_t from = i + 1 - window;
+    const int count = retCount_[i + 1] - retCount_[from];
+    if (count <= 1) return kNaN;
+
+    double sum = retSum_[i + 1] - retSum_[from];
+    double sumSq = retSumSq_[i + 1] - retSumSq_[from];
+    double variance = (sumSq - sum * sum / count) / (count - 1);
+    return std::sqrt(std::max(variance, 0.0));
+}
+
+// ------------------- GridSearch -------------------
+
+std::vector<GridPoint> GridPoints(const GridSearchSpec& spec, int lookback) {
+    std::vector<GridPoint> points;
+    for (double threshold : spec.thresholds) {
+        for (int window : spec.trendWindows) {
+            points.push_back({ GridStrategy::Trending, window, threshold, lookback });
+        }
+        for (int window : spec.reversionWindows) {
+            points.push_back({ GridStrategy::MeanReversion, window, threshold, lookback });
+        }
+    }
+    if (spec.includeBuyAndHold) {
+        points.push_back({ GridStrategy::BuyAndHold, 0, kNaN, lookback });
+    }
+    return points;
+}
+
+std::string GridStrategyName(GridStrategy strategy) {
+    switch (strategy) {
+    case GridStrategy::Trending: return TrendingStrategy().getName();
+    case GridStrategy::MeanReversion: return MeanReversionStrategy().getName();
+    case GridStrategy::BuyAndHold: break;
+    }
+    return BuyAndHoldStrategy().getName();
+}
+
+// Same signals as the strategies' analyzeSeries, from the prefix sums
+double GridPosition(const PrefixIndicators& ind, const GridPoint& point, size_t i, size_t origin) {
+    double vol = point.strategy == GridStrategy::MeanReversion ? ind.Volatility(i, point.window, origin) : kNaN;
+    return SignalPosition(point, ind.Close()[i], ind.Sma(i, point.window, origin), vol);
+}
+
+bool BetterGridResult(const GridResult& a, const GridResult& b) {
+    double sa = a.performance.score;
+    double sb = b.performance.score;
+    if (std::isnan(sb)) return !std::isnan(sa);
+    return sa > sb;
+}
+
+std::vector<GridResult> GridSearch::Run(const GridSearchSpec& spec) const {
+    const PrefixIndicators& ind = indicators_;
+    const size_t n = ind.size();
+
+    std::vector<GridPoint> points;
+    for (int lookback : spec.lookbacks) {
+        if (lookback <= 0 || n < static_cast<size_t>(lookback) + 20) continue;
+        std::vector<GridPoint> forLookback = GridPoints(spec, lookback);
+        points.insert(points.end(), forLookback.begin(), forLookback.end());
+    }
+
+    // Each point backtests the last `lookback` bars. Positions are computed
+    // on the fly (with the window's first bar as origin), so a point costs
+    // O(lookback). The SMA comes from the prefix sums; the volatility is
+    // streamed through OnlineVolatility over the window, the computation
+    // MeanReversionStrategy gets from RollingVolatility on the slice, so a
+    // z-score near the threshold lands on the same side as in the selector.
+    std::vector<GridResult> results(points.size());
+    ParallelFor(points.size(), [&](size_t p) {
+        const GridPoint& point = points[p];
+        const size_t origin = n - point.lookback;
+        const PriceColumn close(ind.Close().data() + origin, point.lookback);
+
+        OnlineReturn ret;
+        OnlineVolatility vol(point.strategy == GridStrategy::MeanReversion ? point.window : 0);
+        BacktestResult backtest = RunBacktestWith(close, [&](size_t i) {
+            return SignalPosition(point, close[i], ind.Sma(origin + i, point.window, origin),
+                                  vol.Update(ret.Update(close[i])));
+        });
+        std::string name = GridStrategyName(point.strategy);
+        results[p] = { name, point.window, point.threshold, point.lookback,
+                       MakePerformance(name, backtest) };
+    });
+
+    std::stable_sort(results.begin(), results.end(), BetterGridResult);
+    return results;
+}
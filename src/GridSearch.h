@@ -0,0 +1,106 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "PriceSeries.h"
+#include "StrategySelector.h"
+
+// Prefix sums over a whole series (closes, and the valid daily returns, their
+// squares and count), so any SMA or rolling-volatility window costs O(1) per
+// bar and every grid point shares one O(n) precomputation.
+//
+// `origin` reproduces backtesting on data.Slice(origin, ...): a window that
+// would reach back before the origin yields NaN, exactly as the batch
+// functions report warm-up bars on the slice.
+class PrefixIndicators {
+public:
+    explicit PrefixIndicators(const PriceSeries& data);
+
+    size_t size() const { return close_.size(); }
+    PriceColumn Close() const { return close_; }
+
+    // Mean close over bars [i - window + 1, i]
+    double Sma(size_t i, int window, size_t origin = 0) const;
+
+    // Sample standard deviation of the valid returns in (i - window, i]; NaN
+    // before bar origin + window or with fewer than two valid returns. Taken
+    // from the sums and sums of squares, it can differ from RollingVolatility
+    // (Welford with periodic rebuilds) in the last few digits: within a
+    // relative 1e-10 on long series. GridSearch::Run streams the exact value
+    // instead; walk-forward positions only have to agree with themselves.
+    double Volatility(size_t i, int window, size_t origin = 0) const;
+
+private:
+    PriceSeries data_;               // keeps close_ alive
+    PriceColumn close_;
+    double base_ = 0.0;              // first close; sums are taken relative to it
+    std::vector<double> closeSum_;   // closeSum_[k] = sum of (close - base_) over [0, k)
+    std::vector<double> retSum_;     // same for valid returns
+    std::vector<double> retSumSq_;
+    std::vector<int> retCount_;
+};
+
+// Parameter ranges swept by GridSearch::Run
+struct GridSearchSpec {
+    std::vector<int> trendWindows = { 10, 20, 30, 50, 100, 150, 200 };  // TrendingStrategy SMA
+    std::vector<int> reversionWindows = { 10, 15, 20, 30, 50 };         // MeanReversionStrategy window
+    std::vector<double> thresholds = { 2.5, 5.0, 7.5, 10.0 };           // |signal| to trade
+    std::vector<int> lookbacks = { 100, 250, 500 };                     // backtest length in bars
+    bool includeBuyAndHold = true;                                      // one baseline per lookback
+};
+
+// Strategy family a grid point tunes
+enum class GridStrategy {
+    Trending,       // TrendingStrategy(window, threshold)
+    MeanReversion,  // MeanReversionStrategy(window, threshold)
+    BuyAndHold      // BuyAndHoldStrategy (window and threshold unused)
+};
+
+// One parameter combination
+struct GridPoint {
+    GridStrategy strategy;
+    int window;
+    double threshold;
+    int lookback;
+};
+
+// Every strategy/window/threshold combination of spec (plus the buy & hold
+// baseline when requested), all with the given lookback
+std::vector<GridPoint> GridPoints(const GridSearchSpec& spec, int lookback);
+
+// AnalysisStrategy::getName() of the strategy a grid point tunes
+std::string GridStrategyName(GridStrategy strategy);
+
+// Position the grid point's strategy holds after bar i (+1, -1 or 0), with
+// indicators computed as if the series started at bar origin
+double GridPosition(const PrefixIndicators& ind, const GridPoint& point, size_t i, size_t origin);
+
+// One evaluated grid point
+struct GridResult {
+    std::string strategy;     // AnalysisStrategy::getName() of the strategy being tuned
+    int window;               // SMA / z-score window (0 for buy & hold)
+    double threshold;         // signal threshold (NaN for buy & hold)
+    int lookback;             // backtest length in bars
+    StrategyPerformance performance;
+};
+
+// Ranking order for grid results: higher score first, NaN scores last
+bool BetterGridResult(const GridResult& a, const GridResult& b);
+
+// Sweeps strategy parameters over one series. Each grid point produces the
+// same performance as StrategySelector(lookback) backtesting the matching
+// TrendingStrategy / MeanReversionStrategy / BuyAndHoldStrategy, but SMAs
+// come from the shared PrefixIndicators instead of being recomputed per
+// point, and points are spread over the shared thread pool.
+class GridSearch {
+public:
+    explicit GridSearch(const PriceSeries& data) : indicators_(data) {}
+
+    // Every grid point with enough history (lookback + 20 bars, as in
+    // StrategySelector), best score first; NaN scores sort last
+    std::vector<GridResult> Run(const GridSearchSpec& spec = GridSearchSpec()) const;
+
+    const PrefixIndicators& indicators() const { return indicators_; }
+
+private:
+    PrefixIndicators indicators_;
+};
@@ -0,0 +1,67 @@
+#include "IndicatorPipeline.h"
+#include "OnlineIndicators.h"
+#include <limits>
+
+const IndicatorResults& IndicatorPipeline::Run(const PriceSeries& data) {
+    const PriceColumn close = data.Close();
+    const int n = static_cast<int>(close.size());
+    IndicatorResults& out = results_;
+
+    const int smaWindow = spec_.smaWindow;
+    const int volWindow = spec_.volatilityWindow;
+    const int bandWindow = spec_.bollingerWindow;
+    const bool wantSma = smaWindow > 0;
+    const bool wantVol = volWindow > 0;
+    const bool wantBands = bandWindow > 0;
+
+    // resize() keeps capacity, so a reused pipeline only allocates for a
+    // series longer than any it has seen before
+    out.returns.resize(n);
+    out.sma.resize(wantSma ? n : 0);
+    out.volatility.resize(wantVol ? n : 0);
+    out.bollingerMiddle.resize(wantBands ? n : 0);
+    out.bollingerUpper.resize(wantBands ? n : 0);
+    out.bollingerLower.resize(wantBands ? n : 0);
+
+    OnlineReturn ret;
+    OnlineReturnStats returnStats;
+    OnlineSMA sma(smaWindow);
+    OnlineVolatility volatility(volWindow);
+    OnlineBollinger bands(bandWindow, spec_.bollingerStdDev);
+    OnlineDrawdown drawdown;
+
+    for (int i = 0; i < n; ++i) {
+        const double price = close[i];
+        const double r = ret.Update(price);
+        out.returns[i] = r;
+
+        if (spec_.returnStats) returnStats.Update(r);
+        if (wantSma) out.sma[i] = sma.Update(price);
+        if (wantVol) out.volatility[i] = volatility.Update(r);
+        if (wantBands) {
+            bands.Update(price);
+            out.bollingerMiddle[i] = bands.middle();
+            out.bollingerUpper[i] = bands.upper();
+            out.bollingerLower[i] = bands.lower();
+        }
+        if (spec_.drawdown) drawdown.Update(price);
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.stats = spec_.returnStats ? returnStats.stats() : ReturnStats{ nan, nan, nan, nan };
+    out.sharpe = spec_.returnStats ? returnStats.Sharpe(spec_.riskFreeRate) : nan;
+    out.periodReturn = (n >= 2 && close.front() != 0.0)
+        ? (close.back() - close.front()) / close.front()
+        : nan;
+    out.maxDrawdown = spec_.drawdown ? drawdown.maxDrawdown() : nan;
+
+    // Second pass: whole-series statistics of the returns computed above
+    if (spec_.acfMaxLag > 0) {
+        out.autocorrelation = analytics_.AutocorrelationSpectrum(out.returns, spec_.acfMaxLag);
+    } else {
+        out.autocorrelation = { {}, 0, nan, nan, 0, nan };
+    }
+    out.hurst = spec_.hurst ? analytics_.HurstExponent(out.returns) : nan;
+
+    return out;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "PriceSeries.h"
+#include "StockAnalytics.h"
+
+// Which indicators an IndicatorPipeline computes. A window of 0 (or false)
+// leaves that indicator out: its vector stays empty and its scalar is NaN.
+// Daily returns are always computed since most of the others build on them.
+struct IndicatorSpec {
+    int smaWindow = 20;             // SimpleMovingAverage of close
+    int volatilityWindow = 20;      // RollingVolatility of returns
+    int bollingerWindow = 20;       // BollingerBands of close
+    double bollingerStdDev = 2.0;
+    bool returnStats = true;        // ComputeReturnStats + SharpeRatio
+    double riskFreeRate = 0.0;      // per period, for the Sharpe ratio
+    bool drawdown = true;           // MaxDrawdown
+    int acfMaxLag = 20;             // AutocorrelationSpectrum of returns
+    bool hurst = true;              // HurstExponent of returns
+};
+
+// Everything one IndicatorPipeline::Run produces. Vectors are indexed like the
+// input bars and hold the same values as the matching StockAnalytics call.
+struct IndicatorResults {
+    std::vector<double> returns;
+    std::vector<double> sma;
+    std::vector<double> volatility;
+    std::vector<double> bollingerMiddle;
+    std::vector<double> bollingerUpper;
+    std::vector<double> bollingerLower;
+
+    ReturnStats stats;
+    double sharpe;
+    double periodReturn;            // YearToDatePerformance over the whole series
+    double maxDrawdown;
+    AcfResult autocorrelation;
+    double hurst;
+};
+
+// Computes a declared set of indicators with one fused pass over the close
+// column instead of one pass (and one allocation) per StockAnalytics call.
+//
+// The streaming indicators (returns, SMA, volatility, Bollinger, drawdown,
+// return stats) share a single loop; the autocorrelation spectrum and Hurst
+// exponent then read the returns that loop produced. Output vectors are kept
+// between runs, so reusing a pipeline across tickers does not reallocate once
+// it has seen the longest series.
+class IndicatorPipeline {
+public:
+    explicit IndicatorPipeline(const IndicatorSpec& spec = IndicatorSpec()) : spec_(spec) {}
+
+    // Compute every requested indicator for data. The returned reference stays
+    // valid (and is overwritten) until the next Run.
+    const IndicatorResults& Run(const PriceSeries& data);
+
+    const IndicatorResults& results() const { return results_; }
+    const IndicatorSpec& spec() const { return spec_; }
+
+private:
+    IndicatorSpec spec_;
+    IndicatorResults results_;
+    StockAnalytics analytics_;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal streaming JSON builder for the machine-readable outputs. Commas
+// between members and elements are inserted automatically; the caller is
+// responsible for pairing Begin/End calls and for giving every object
+// member a Key() first.
+//
+//   JsonWriter json;
+//   json.BeginObject().Key("ticker").String("NVDA").Key("close").Number(137.5).EndObject();
+//   json.str()  // {"ticker":"NVDA","close":137.5}
+//
+// Numbers are formatted with std::to_chars straight into the output buffer
+// (no locale, no stream state); Reserve() up front and a whole report is
+// built without reallocating. Non-finite numbers are written as null, since
+// JSON has no NaN or infinity.
+class JsonWriter {
+public:
+    JsonWriter() = default;
+
+    // Continue after whatever buffer already holds (e.g. earlier lines of a
+    // JSON-lines stream); Take() hands back the whole buffer
+    explicit JsonWriter(std::string buffer) : out_(std::move(buffer)) {}
+
+    // Preallocate room for roughly bytes more output
+    void Reserve(size_t bytes) { out_.reserve(out_.size() + bytes); }
+
+    JsonWriter& BeginObject() { Separate(); out_ += '{'; first_.push_back(true); return *this; }
+    JsonWriter& EndObject() { out_ += '}'; first_.pop_back(); return *this; }
+    JsonWriter& BeginArray() { Separate(); out_ += '['; first_.push_back(true); return *this; }
+    JsonWriter& EndArray() { out_ += ']'; first_.pop_back(); return *this; }
+
+    JsonWriter& Key(std::string_view key) {
+        Separate();
+        Quote(key);
+        out_ += ':';
+        afterKey_ = true;
+        return *this;
+    }
+
+    JsonWriter& String(std::string_view value) { Separate(); Quote(value); return *this; }
+    JsonWriter& Bool(bool value) { Separate(); out_ += value ? "true" : "false"; return *this; }
+    JsonWriter& Null() { Separate(); out_ += "null"; return *this; }
+
+    JsonWriter& Int(long long value) {
+        Separate();
+        char buf[24];
+        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        return *this;
+    }
+
+    // Shortest form that reads back as the same double
+    JsonWriter& Number(double value) {
+        Separate();
+        if (!std::isfinite(value)) {
+            out_ += "null";
+            return *this;
+        }
+        char buf[32];
+        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        return *this;
+    }
+
+    // Insert already-serialized JSON as the next value
+    JsonWriter& Raw(std::string_view json) { Separate(); out_ += json; return *this; }
+
+    const std::string& str() const { return out_; }
+    std::string Take() { first_.clear(); afterKey_ = false; return std::move(out_); }
+
+private:
+    // Comma before every element or member except the first of its container
+    void Separate() {
+        if (afterKey_) {
+            afterKey_ = false;
+            return;
+        }
+        if (first_.empty()) return;
+        if (!first_.back()) out_ += ',';
+        first_.back() = false;
+    }
+
+    void Quote(std::string_view s) {
+        out_ += '"';
+        for (char c : s) {
+            switch (c) {
+            case '"': out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out_ += buf;
+                } else {
+                    out_ += c;
+                }
+            }
+        }
+        out_ += '"';
+    }
+
+    std::string out_;
+    std::vector<bool> first_;  // per open container: nothing written into it yet
+    bool afterKey_ = false;
+};
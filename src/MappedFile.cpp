@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mtimeNs_(std::exchange(other.mtimeNs_, 0)),
+      open_(std::exchange(other.open_, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mtimeNs_ = std::exchange(other.mtimeNs_, 0);
+        open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    const int64_t mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        // mmap rejects zero-length mappings; an empty file is still a valid file
+        ::close(fd);
+        mtimeNs_ = mtimeNs;
+        open_ = true;
+        return true;
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference to the file
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    // We scan front to back exactly once; let the kernel read ahead aggressively
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char*>(addr);
+    size_ = size;
+    mtimeNs_ = mtimeNs;
+    open_ = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mtimeNs_ = 0;
+    open_ = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file. The mapping is released when the
+// object is destroyed; views handed out by view() must not outlive it.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file at path. Returns false (and leaves the object empty) on failure.
+    // An existing but empty file maps successfully with size() == 0.
+    bool Open(const std::string& path);
+    void Close();
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    // Modification time of the file when it was mapped (ns since the epoch)
+    int64_t mtimeNs() const { return mtimeNs_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    int64_t mtimeNs_ = 0;
+    bool open_ = false;
+};
@@ -0,0 +1,385 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "PriceSeries.h"
+#include "RollingMoments.h"
+#include "StockAnalytics.h"
+
+// Incremental indicators: each object keeps just enough rolling state to take
+// the next bar in O(1), so signals stay current as bars stream in without
+// re-scanning the history.
+//
+// Update() consumes one value and returns the indicator's value for that bar
+// (NaN while warming up), exactly as the batch StockAnalytics function would
+// report it at the same index. Seed() resets the state and replays a series.
+
+// Last `capacity` values pushed, oldest first
+class RingWindow {
+public:
+    explicit RingWindow(size_t capacity = 0) : values_(capacity) {}
+
+    size_t capacity() const { return values_.size(); }
+    size_t size() const { return size_; }
+    bool full() const { return size_ == values_.size(); }
+
+    // Value i positions after the oldest one
+    double operator[](size_t i) const {
+        size_t at = head_ + i;
+        return values_[at < values_.size() ? at : at - values_.size()];
+    }
+
+    double oldest() const { return values_[head_]; }
+
+    // Append x; when full, the oldest value is overwritten
+    void Push(double x) {
+        if (values_.empty()) return;
+        if (full()) {
+            values_[head_] = x;
+            if (++head_ == values_.size()) head_ = 0;
+        } else {
+            size_t at = head_ + size_;
+            values_[at < values_.size() ? at : at - values_.size()] = x;
+            ++size_;
+        }
+    }
+
+    void Reset() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    std::vector<double> values_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// Simple return from the previous price: NaN for the first bar and after a
+// zero price (same rule as DailyReturns)
+class OnlineReturn {
+public:
+    double Update(double price) {
+        double r = (hasPrev_ && prev_ != 0.0) ? (price - prev_) / prev_
+                                              : std::numeric_limits<double>::quiet_NaN();
+        prev_ = price;
+        hasPrev_ = true;
+        value_ = r;
+        return r;
+    }
+
+    double value() const { return value_; }
+
+    void Reset() { *this = OnlineReturn(); }
+
+private:
+    double prev_ = 0.0;
+    bool hasPrev_ = false;
+    double value_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+// Mean of the last `window` prices, same running-sum arithmetic as
+// SlidingMeanScalar (SimpleMovingAverage may differ in the last bits when it
+// runs vectorized)
+class OnlineSMA {
+public:
+    explicit OnlineSMA(int window) : window_(window), values_(window > 0 ? window : 0) {}
+
+    double Update(double price) {
+        if (window_ <= 0) return value_;
+        if (values_.full()) {
+            sum_ += price;
+            sum_ -= values_.oldest();
+        } else {
+            sum_ += price;
+        }
+        values_.Push(price);
+        value_ = values_.full() ? sum_ / window_ : std::numeric_limits<double>::quiet_NaN();
+        return value_;
+    }
+
+    void Seed(const PriceSeries& data) {
+        Reset();
+        for (double price : data.Close()) Update(price);
+    }
+
+    void Reset() {
+        values_.Reset();
+        sum_ = 0.0;
+        value_ = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    int window() const { return window_; }
+    bool ready() const { return values_.full() && window_ > 0; }
+    double value() const { return value_; }
+
+private:
+    int window_;
+    RingWindow values_;
+    double sum_ = 0.0;
+    double value_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+// Exponential moving average with alpha = 2 / (period + 1). The first value
+// (at bar period - 1) is the simple mean of the first `period` prices, so
+// the average does not depend on an arbitrary starting price.
+class OnlineEMA {
+public:
+    explicit OnlineEMA(int period)
+        : period_(period), alpha_(period > 0 ? 2.0 / (period + 1) : 0.0) {}
+
+    double Update(double price) {
+        if (period_ <= 0) return value_;
+        if (count_ < period_) {
+            seedSum_ += price;
+            if (++count_ == period_) value_ = seedSum_ / period_;
+        } else {
+            value_ += alpha_ * (price - value_);
+        }
+        return value_;
+    }
+
+    void Seed(const PriceSeries& data) {
+        Reset();
+        for (double price : data.Close()) Update(price);
+    }
+
+    void Reset() {
+        count_ = 0;
+        seedSum_ = 0.0;
+        value_ = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    int period() const { return period_; }
+    bool ready() const { return period_ > 0 && count_ >= period_; }
+    double value() const { return value_; }
+
+private:
+    int period_;
+    double alpha_;
+    int count_ = 0;
+    double seedSum_ = 0.0;
+    double value_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+// Rolling sample standard deviation of returns, identical to
+// RollingVolatility(returns, window): NaN returns are skipped, and nothing is
+// reported until `window` returns have been seen past the first one.
+class OnlineVolatility {
+public:
+    explicit OnlineVolatility(int window)
+        : window_(window),
+          rebuildInterval_(std::max(window, 1024)),
+          returns_(window > 0 ? window : 0) {}
+
+    double Update(double ret) {
+        if (window_ <= 0) return value_;
+
+        // Drop the return leaving the window. Every rebuildInterval_ bars the
+        // moments are rebuilt from the live window instead, which sheds the
+        // rounding error the removals accumulate.
+        if (seen_ > window_ && seen_ % rebuildInterval_ == 0) {
+            RebuildMoments();
+        } else if (returns_.full() && !std::isnan(returns_.oldest())) {
+            moments_.Remove(returns_.oldest());
+        }
+
+        if (!std::isnan(ret)) moments_.Add(ret);
+        returns_.Push(ret);
+
+        value_ = (seen_ < window_ || moments_.count() <= 1)
+            ? std::numeric_limits<double>::quiet_NaN()
+            : std::sqrt(moments_.SampleVariance());
+        ++seen_;
+        return value_;
+    }
+
+    void Seed(const std::vector<double>& returns) {
+        Reset();
+        for (double r : returns) Update(r);
+    }
+
+    // Seed from the daily returns of data
+    void Seed(const PriceSeries& data) {
+        Reset();
+        OnlineReturn ret;
+        for (double price : data.Close()) Update(ret.Update(price));
+    }
+
+    void Reset() {
+        moments_.Reset();
+        returns_.Reset();
+        seen_ = 0;
+        value_ = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    int window() const { return window_; }
+    double value() const { return value_; }
+
+private:
+    // Moments of the live window minus its oldest return. Kept out of
+    // Update() so that stays small enough to inline into per-bar loops.
+    void RebuildMoments() {
+        moments_.Reset();
+        for (size_t j = 1; j < returns_.size(); ++j) {
+            if (!std::isnan(returns_[j])) moments_.Add(returns_[j]);
+        }
+    }
+
+    int window_;
+    int rebuildInterval_;
+    RingWindow returns_;
+    RollingMoments moments_;
+    int seen_ = 0;
+    double value_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+// Bollinger bands over the last `window` prices, identical to BollingerBands
+// (population standard deviation from running sums)
+class OnlineBollinger {
+public:
+    OnlineBollinger(int window, double numStdDev = 2.0)
+        : window_(window), numStdDev_(numStdDev), values_(window > 0 ? window : 0) {}
+
+    void Update(double price) {
+        if (window_ <= 0) return;
+        sum_ += price;
+        sumSq_ += price * price;
+        if (values_.full()) {
+            double oldPrice = values_.oldest();
+            sum_ -= oldPrice;
+            sumSq_ -= oldPrice * oldPrice;
+        }
+        values_.Push(price);
+
+        if (!values_.full()) return;
+        double mean = sum_ / window_;
+        double variance = (sumSq_ / window_) - (mean * mean);
+        if (variance < 0.0) variance = 0.0;
+        double stddev = std::sqrt(variance);
+        middle_ = mean;
+        upper_ = mean + numStdDev_ * stddev;
+        lower_ = mean - numStdDev_ * stddev;
+    }
+
+    void Seed(const PriceSeries& data) {
+        Reset();
+        for (double price : data.Close()) Update(price);
+    }
+
+    void Reset() {
+        values_.Reset();
+        sum_ = sumSq_ = 0.0;
+        middle_ = upper_ = lower_ = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    bool ready() const { return window_ > 0 && values_.full(); }
+    double middle() const { return middle_; }
+    double upper() const { return upper_; }
+    double lower() const { return lower_; }
+
+private:
+    int window_;
+    double numStdDev_;
+    RingWindow values_;
+    double sum_ = 0.0;
+    double sumSq_ = 0.0;
+    double middle_ = std::numeric_limits<double>::quiet_NaN();
+    double upper_ = std::numeric_limits<double>::quiet_NaN();
+    double lower_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+// Running peak and worst peak-to-trough drop, identical to MaxDrawdown
+class OnlineDrawdown {
+public:
+    // Returns the worst drawdown so far (a fraction <= 0)
+    double Update(double price) {
+        if (count_++ == 0) peak_ = price;
+        if (price > peak_) peak_ = price;
+        current_ = 0.0;
+        if (peak_ > 0.0) {
+            current_ = (price - peak_) / peak_;
+            if (current_ < maxDrawdown_) maxDrawdown_ = current_;
+        }
+        return maxDrawdown_;
+    }
+
+    void Seed(const PriceSeries& data) {
+        Reset();
+        for (double price : data.Close()) Update(price);
+    }
+
+    void Reset() { *this = OnlineDrawdown(); }
+
+    double peak() const { return peak_; }
+    double current() const { return current_; }  // drop of the latest price from the peak
+    // NaN before the first price, like MaxDrawdown on an empty series
+    double maxDrawdown() const {
+        return count_ > 0 ? maxDrawdown_ : std::numeric_limits<double>::quiet_NaN();
+    }
+
+private:
+    size_t count_ = 0;
+    double peak_ = 0.0;
+    double current_ = 0.0;
+    double maxDrawdown_ = 0.0;
+};
+
+// Mean / population stddev / min / max of the non-NaN returns seen so far,
+// finished the same way as ComputeReturnStats and SharpeRatio
+class OnlineReturnStats {
+public:
+    void Update(double ret) {
+        if (std::isnan(ret)) return;
+        sum_ += ret;
+        sumSq_ += ret * ret;
+        min_ = std::min(min_, ret);
+        max_ = std::max(max_, ret);
+        ++count_;
+    }
+
+    void Seed(const std::vector<double>& returns) {
+        Reset();
+        for (double r : returns) Update(r);
+    }
+
+    // Seed from the daily returns of data
+    void Seed(const PriceSeries& data) {
+        Reset();
+        OnlineReturn ret;
+        for (double price : data.Close()) Update(ret.Update(price));
+    }
+
+    void Reset() { *this = OnlineReturnStats(); }
+
+    size_t count() const { return count_; }
+
+    ReturnStats stats() const {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        if (count_ == 0) return { nan, nan, nan, nan };
+        ReturnStats s;
+        s.mean = sum_ / count_;
+        double variance = (sumSq_ / count_) - (s.mean * s.mean);
+        if (variance < 0.0) variance = 0.0; // guard against tiny negatives
+        s.stddev = std::sqrt(variance);
+        s.min = min_;
+        s.max = max_;
+        return s;
+    }
+
+    double Sharpe(double riskFreeRate = 0.0) const {
+        ReturnStats s = stats();
+        if (std::isnan(s.mean) || std::isnan(s.stddev) || s.stddev == 0.0) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return (s.mean - riskFreeRate) / s.stddev;
+    }
+
+private:
+    double sum_ = 0.0;
+    double sumSq_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+    size_t count_ = 0;
+};
@@ -0,0 +1,149 @@
+#include "Portfolio.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ------------------- AlignedPanel -------------------
+
+AlignedPanel::AlignedPanel(std::vector<std::string> tickers, std::vector<PriceSeries> series)
+    : tickers_(std::move(tickers)), series_(std::move(series)) {
+    series_.resize(tickers_.size());
+
+    size_t total = 0;
+    for (const auto& s : series_) total += s.size();
+    dates_.reserve(total);
+    for (const auto& s : series_) {
+        const DateColumn dates = s.Dates();
+        dates_.insert(dates_.end(), dates.begin(), dates.end());
+    }
+    std::sort(dates_.begin(), dates_.end());
+    dates_.erase(std::unique(dates_.begin(), dates_.end()), dates_.end());
+
+    const size_t n = rows();
+    const size_t m = cols();
+    close_.assign(n * m, 0.0);
+    listed_.assign(n * m, 0);
+    barRows_.resize(m);
+
+    for (size_t j = 0; j < m; ++j) {
+        const PriceSeries& s = series_[j];
+        const DateColumn dates = s.Dates();
+        const PriceColumn close = s.Close();
+        std::vector<size_t>& barRows = barRows_[j];
+        barRows.reserve(s.size());
+
+        // Bars are in date order, so each lookup resumes where the last ended
+        auto from = dates_.begin();
+        for (size_t i = 0; i < s.size(); ++i) {
+            from = std::lower_bound(from, dates_.end(), dates[i]);
+            barRows.push_back(from - dates_.begin());
+        }
+        if (barRows.empty()) continue;
+
+        // Real closes, forward-filled across the ticker's missing days and
+        // past its last bar (so holdings still open there keep their value)
+        size_t bar = 0;
+        double last = close[0];
+        for (size_t row = barRows.front(); row < n; ++row) {
+            while (bar < barRows.size() && barRows[bar] == row) last = close[bar++];
+            close_[row * m + j] = last;
+            listed_[row * m + j] = row <= barRows.back();
+        }
+    }
+}
+
+// ------------------- Portfolio backtest -------------------
+
+std::vector<double> StrategyPositions(const AlignedPanel& panel, AnalysisStrategy& strategy) {
+    const size_t n = panel.rows();
+    const size_t m = panel.cols();
+    const PositionRule rule = strategy.positionRule();
+    std::vector<double> positions(n * m, 0.0);
+
+    for (size_t j = 0; j < m; ++j) {
+        const PriceSeries& s = panel.Series(j);
+        if (s.empty()) continue;
+        const std::vector<double> signals = strategy.analyzeSeries(s);
+        const std::vector<size_t>& barRows = panel.BarRows(j);
+
+        size_t bar = 0;
+        double position = 0.0;
+        for (size_t row = panel.FirstRow(j); row <= panel.LastRow(j); ++row) {
+            while (bar < barRows.size() && barRows[bar] == row) position = rule.PositionFor(signals[bar++]);
+            positions[row * m + j] = position;
+        }
+    }
+    return positions;
+}
+
+PortfolioResult RunPortfolio(const AlignedPanel& panel, const std::vector<double>& positions,
+                             const PortfolioSpec& spec) {
+    const size_t n = panel.rows();
+    const size_t m = panel.cols();
+    const size_t every = std::max(spec.rebalanceEvery, 1);
+
+    PortfolioResult result;
+    result.performance = { 0.0, 0.0, 0.0, 0.0, 0.0, 0 };
+    result.finalWeights.assign(m, 0.0);
+    if (n == 0 || m == 0) return result;
+
+    // Holdings are share counts; equity is cash plus their value at the
+    // current row's closes
+    std::vector<double> units(m, 0.0);
+    std::vector<double> invested(n, 0.0);  // 1 when anything is held from row i to i + 1
+    result.equity.assign(n, 1.0);
+    double cash = 1.0;
+    double turnover = 0.0;
+
+    for (size_t row = 0; row < n; ++row) {
+        const double* close = panel.CloseRow(row);
+        double equity = cash;
+        for (size_t j = 0; j < m; ++j) equity += units[j] * close[j];
+        result.equity[row] = equity;
+
+        if (row % every == 0 && row + 1 < n && equity > 0.0) {
+            const double* target = positions.data() + row * m;
+            const uint8_t* listed = panel.ListedRow(row);
+            auto wanted = [&](size_t j) {
+                return listed[j] && (target[j] > 0.0 || (spec.allowShort && target[j] < 0.0));
+            };
+            size_t held = 0;
+            for (size_t j = 0; j < m; ++j) held += wanted(j);
+
+            const double weight = held > 0 ? 1.0 / held : 0.0;
+            double exposure = 0.0;
+            for (size_t j = 0; j < m; ++j) {
+                const double current = units[j] * close[j] / equity;
+                const double next = wanted(j) ? target[j] * weight : 0.0;
+                turnover += std::fabs(next - current);
+                units[j] = next != 0.0 ? next * equity / close[j] : 0.0;
+                exposure += units[j] * close[j];
+            }
+            cash = equity - exposure;
+            ++result.rebalances;
+        }
+
+        for (size_t j = 0; j < m; ++j) {
+            if (units[j] != 0.0) {
+                invested[row] = 1.0;
+                break;
+            }
+        }
+    }
+
+    const double* lastClose = panel.CloseRow(n - 1);
+    for (size_t j = 0; j < m; ++j) {
+        result.finalWeights[j] = units[j] * lastClose[j] / result.equity[n - 1];
+    }
+
+    // The single-asset kernel over the equity curve gives the same return,
+    // Sharpe, drawdown and win-rate definitions as every other backtest
+    result.performance = RunBacktest(PriceColumn(result.equity.data(), n), invested.data());
+    result.performance.turnover = turnover;
+    return result;
+}
+
+PortfolioResult RunPortfolio(const AlignedPanel& panel, AnalysisStrategy& strategy,
+                             const PortfolioSpec& spec) {
+    return RunPortfolio(panel, StrategyPositions(panel, strategy), spec);
+}
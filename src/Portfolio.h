@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AnalysisStrategy.h"
+#include "BacktestKernel.h"
+#include "PriceSeries.h"
+
+// Several tickers aligned on one trading calendar: the sorted union of every
+// series' dates. Closes are stored as a dense row-major date x ticker matrix,
+// so everything that happens on one day reads one contiguous row.
+//
+// A ticker is listed from its first bar through its last. Days in between
+// where it has no bar (exchange holidays in only one file, gaps) repeat the
+// previous close, and so do the days after its last bar. The mask is 1 only
+// while listed; before the first bar the close is 0.
+class AlignedPanel {
+public:
+    AlignedPanel(std::vector<std::string> tickers, std::vector<PriceSeries> series);
+
+    size_t rows() const { return dates_.size(); }    // trading days
+    size_t cols() const { return tickers_.size(); }  // tickers
+
+    const std::vector<int32_t>& Dates() const { return dates_; }
+    const std::vector<std::string>& Tickers() const { return tickers_; }
+    const PriceSeries& Series(size_t ticker) const { return series_[ticker]; }
+
+    const double* CloseRow(size_t row) const { return close_.data() + row * cols(); }
+    const uint8_t* ListedRow(size_t row) const { return listed_.data() + row * cols(); }
+
+    // Calendar row of each of the ticker's own bars
+    const std::vector<size_t>& BarRows(size_t ticker) const { return barRows_[ticker]; }
+
+    // Rows where the ticker is listed: [FirstRow, LastRow]
+    size_t FirstRow(size_t ticker) const { return barRows_[ticker].empty() ? rows() : barRows_[ticker].front(); }
+    size_t LastRow(size_t ticker) const { return barRows_[ticker].empty() ? 0 : barRows_[ticker].back(); }
+
+private:
+    std::vector<std::string> tickers_;
+    std::vector<PriceSeries> series_;
+    std::vector<int32_t> dates_;
+    std::vector<double> close_;     // rows() x cols(), row-major
+    std::vector<uint8_t> listed_;   // rows() x cols(), 1 while listed
+    std::vector<std::vector<size_t>> barRows_;
+};
+
+struct PortfolioSpec {
+    int rebalanceEvery = 21;  // trading days between rebalances (about monthly)
+    bool allowShort = false;  // hold -1 positions short; otherwise they stay in cash
+};
+
+// Portfolio equity over the panel's calendar. Equity starts at 1.0 on the
+// first day; between rebalances the holdings drift with prices.
+struct PortfolioResult {
+    std::vector<double> equity;       // one value per calendar row
+    BacktestResult performance;       // of the equity curve; turnover is the sum of
+                                      // |weight change| over all rebalances
+    int rebalances = 0;
+    std::vector<double> finalWeights; // per ticker, at the last close
+};
+
+// Target positions (+1 long, -1 short, 0 flat) for every calendar row and
+// ticker, rows() x cols() row-major: the strategy's signal on each ticker's
+// own history, carried over days the ticker has no bar, turned into a
+// position with its positionRule(). Unlisted cells are 0.
+std::vector<double> StrategyPositions(const AlignedPanel& panel, AnalysisStrategy& strategy);
+
+// Rebalance every spec.rebalanceEvery rows (starting with row 0) to equal
+// weights across the listed tickers with a long position (and short ones when
+// spec.allowShort), signed by the position, so gross exposure is 1 when
+// anything is held and the rest is cash. Tickers delisted between rebalances
+// are held at their last close until the next one. positions is
+// rows() x cols() row-major.
+PortfolioResult RunPortfolio(const AlignedPanel& panel, const std::vector<double>& positions,
+                             const PortfolioSpec& spec = PortfolioSpec());
+
+// StrategyPositions + RunPortfolio
+PortfolioResult RunPortfolio(const AlignedPanel& panel, AnalysisStrategy& strategy,
+                             const PortfolioSpec& spec = PortfolioSpec());
@@ -0,0 +1,196 @@
+#include "PriceCsvParser.h"
+#include "TradingDate.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Field roles, used as indices into the per-row value array
+enum FieldRole : signed char {
+    kIgnore = -1,
+    kOpen = 0,
+    kHigh,
+    kLow,
+    kClose,
+    kVolume,
+    kDate,
+    kRoleCount
+};
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '"')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// Case-insensitive match that also treats ' ' and '_' as equivalent ("Adj Close" == "adj_close")
+bool HeaderEquals(std::string_view name, std::string_view expected) {
+    if (name.size() != expected.size()) return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c == ' ') c = '_';
+        if (c != expected[i]) return false;
+    }
+    return true;
+}
+
+bool ParseNumber(std::string_view field, double& out) {
+    field = Trim(field);
+    // from_chars takes no explicit plus sign; a sign must still lead a number
+    if (field.size() > 1 && field.front() == '+' && field[1] != '-' && field[1] != '+') {
+        field.remove_prefix(1);
+    }
+    if (field.empty()) return false;
+    auto res = std::from_chars(field.data(), field.data() + field.size(), out);
+    return res.ec == std::errc() && res.ptr == field.data() + field.size();
+}
+
+size_t CountLines(const char* p, const char* end) {
+    size_t lines = 0;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        ++lines;
+        if (!nl) break;
+        p = nl + 1;
+    }
+    return lines;
+}
+
+} // namespace
+
+bool PriceCsvParser::ParseHeader(std::string_view headerLine, CsvLayout& layout, std::string& error) {
+    layout = CsvLayout();
+
+    // Strip a UTF-8 byte order mark if the file was saved by a spreadsheet
+    if (headerLine.size() >= 3 && std::memcmp(headerLine.data(), "\xEF\xBB\xBF", 3) == 0) {
+        headerLine.remove_prefix(3);
+    }
+
+    int adjClose = -1;
+    int index = 0;
+    size_t pos = 0;
+    while (true) {
+        size_t comma = headerLine.find(',', pos);
+        std::string_view name = Trim(headerLine.substr(pos, comma == std::string_view::npos
+                                                                ? std::string_view::npos
+                                                                : comma - pos));
+
+        if (HeaderEquals(name, "date") || HeaderEquals(name, "datetime") || HeaderEquals(name, "timestamp")) {
+            if (layout.date < 0) layout.date = index;
+        } else if (HeaderEquals(name, "open")) {
+            layout.open = index;
+        } else if (HeaderEquals(name, "high")) {
+            layout.high = index;
+        } else if (HeaderEquals(name, "low")) {
+            layout.low = index;
+        } else if (HeaderEquals(name, "close")) {
+            layout.close = index;
+        } else if (HeaderEquals(name, "adj_close")) {
+            adjClose = index;
+        } else if (HeaderEquals(name, "volume")) {
+            layout.volume = index;
+        }
+
+        ++index;
+        if (comma == std::string_view::npos) break;
+        pos = comma + 1;
+    }
+    layout.fieldCount = index;
+
+    // Only fall back to the adjusted close when there is no raw close column
+    if (layout.close < 0) layout.close = adjClose;
+
+    if (layout.date < 0 || layout.close < 0) {
+        error = "CSV header has no Date/Close columns: " + std::string(headerLine);
+        return false;
+    }
+    return true;
+}
+
+PriceSeries PriceCsvParser::Parse(std::string_view text, std::string& error) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    const char* headerEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!headerEnd) headerEnd = end;
+
+    CsvLayout layout;
+    if (!ParseHeader(std::string_view(p, headerEnd - p), layout, error)) {
+        return PriceSeries();
+    }
+    p = std::min(headerEnd + 1, end);
+
+    // Role of each field position; built once so the row loop is a table lookup
+    std::vector<signed char> roles(layout.fieldCount, kIgnore);
+    roles[layout.date] = kDate;
+    roles[layout.close] = kClose;
+    if (layout.open >= 0) roles[layout.open] = kOpen;
+    if (layout.high >= 0) roles[layout.high] = kHigh;
+    if (layout.low >= 0) roles[layout.low] = kLow;
+    if (layout.volume >= 0) roles[layout.volume] = kVolume;
+
+    const int fieldCount = layout.fieldCount;
+    const int lastMapped = std::max({layout.date, layout.open, layout.high,
+                                     layout.low, layout.close, layout.volume});
+    const bool hasOpen = layout.open >= 0;
+    const bool hasHigh = layout.high >= 0;
+    const bool hasLow = layout.low >= 0;
+
+    PriceSeriesBuilder builder;
+    builder.Reserve(CountLines(p, end));
+
+    double values[kDate];
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* next = lineEnd ? lineEnd + 1 : end;
+        if (!lineEnd) lineEnd = end;
+
+        int32_t date = 0;
+        values[kOpen] = values[kHigh] = values[kLow] = values[kVolume] = 0.0;
+        bool ok = true;
+        int field = 0;
+
+        const char* f = p;
+        for (; field < fieldCount; ++field) {
+            const char* comma = static_cast<const char*>(std::memchr(f, ',', lineEnd - f));
+            const char* fieldEnd = comma ? comma : lineEnd;
+            std::string_view cell(f, fieldEnd - f);
+
+            signed char role = roles[field];
+            if (role == kDate) {
+                ok = ParseDate(Trim(cell), date);
+                if (!ok) break;
+            } else if (role == kVolume) {
+                // Volume is informational: a blank or unreadable cell is 0,
+                // as if the file had no volume column
+                if (!ParseNumber(cell, values[kVolume])) values[kVolume] = 0.0;
+            } else if (role != kIgnore && !ParseNumber(cell, values[role])) {
+                ok = false;  // e.g. "null" rows in Yahoo downloads
+                break;
+            }
+
+            if (!comma) break;
+            f = comma + 1;
+        }
+
+        p = next;
+        // Short rows (including blank lines) never reached every mapped column
+        if (!ok || field < lastMapped) continue;
+
+        double close = values[kClose];
+        builder.Append(date,
+                       hasOpen ? values[kOpen] : close,
+                       hasHigh ? values[kHigh] : close,
+                       hasLow ? values[kLow] : close,
+                       close,
+                       values[kVolume]);
+    }
+
+    return builder.Build();
+}
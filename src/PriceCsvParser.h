@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PriceSeries.h"
+
+// Where each price field lives within a CSV row, resolved once from the header.
+// Indices are -1 for fields the file does not provide.
+struct CsvLayout {
+    int date = -1;
+    int open = -1;
+    int high = -1;
+    int low = -1;
+    int close = -1;
+    int volume = -1;
+    int fieldCount = 0;
+};
+
+// Single-pass parser for daily price CSVs.
+//
+// Header names are matched case-insensitively, so the Yahoo layouts shipped in
+// src/ ("Date,Close,High,Low,Open,Volume", with or without a leading index
+// column and "Adj Close") and the lowercase layout written by fetch_api.py all
+// load through the same path. Numbers are converted with std::from_chars
+// directly from the input buffer and dates are converted to epoch days (see
+// TradingDate.h) on the spot; nothing is allocated per row.
+//
+// Quoted fields are not supported (price files never need them).
+class PriceCsvParser {
+public:
+    // Parse a complete document (header line followed by rows). Rows with an
+    // unparseable date or a missing or non-numeric price (open/high/low/close)
+    // are skipped, as are blank and short lines. A blank or non-numeric volume
+    // reads as 0, like a file without a volume column. Lines may end in LF or
+    // CRLF, the last one may lack its newline, and a UTF-8 BOM is ignored.
+    // Returns an empty series and sets error if the header has no usable
+    // date/close columns.
+    static PriceSeries Parse(std::string_view text, std::string& error);
+
+    static bool ParseHeader(std::string_view headerLine, CsvLayout& layout, std::string& error);
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include "StockData.h"
+
+// Allocator handing out cache-line aligned blocks, so every price column starts
+// on a 64-byte boundary and can be streamed with aligned vector loads.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+using AlignedColumn = std::vector<double, AlignedAllocator<double>>;
+
+// Read-only view over one contiguous column of a PriceSeries
+template <typename T>
+class ColumnView {
+public:
+    ColumnView() = default;
+    ColumnView(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T operator[](size_t i) const { return data_[i]; }
+    T front() const { return data_[0]; }
+    T back() const { return data_[size_ - 1]; }
+
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+using PriceColumn = ColumnView<double>;
+using DateColumn = ColumnView<int32_t>;  // days since 1970-01-01
+
+// Structure-of-arrays price history: one contiguous column per field instead of
+// one StockData per bar, so a scan over closes only touches close prices.
+//
+// A PriceSeries is an immutable view onto shared column storage. Copies and
+// Slice() are O(1) and never duplicate the underlying data.
+class PriceSeries {
+public:
+    PriceSeries() = default;
+
+    // Adapter from the row-oriented representation. Intentionally implicit so
+    // code still holding a std::vector<StockData> can call the series-based API.
+    PriceSeries(const std::vector<StockData>& bars);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    PriceColumn Open() const   { return PriceColumn(open_, size_); }
+    PriceColumn High() const   { return PriceColumn(high_, size_); }
+    PriceColumn Low() const    { return PriceColumn(low_, size_); }
+    PriceColumn Close() const  { return PriceColumn(close_, size_); }
+    PriceColumn Volume() const { return PriceColumn(volume_, size_); }
+    DateColumn Dates() const   { return DateColumn(dates_, size_); }
+
+    int32_t Date(size_t i) const { return dates_[i]; }
+
+    StockData Bar(size_t i) const {
+        return { dates_[i], open_[i], high_[i], low_[i], close_[i], volume_[i] };
+    }
+
+    std::vector<StockData> ToBars() const {
+        std::vector<StockData> bars;
+        bars.reserve(size_);
+        for (size_t i = 0; i < size_; ++i) bars.push_back(Bar(i));
+        return bars;
+    }
+
+    // Wrap columns that live in externally managed memory (e.g. a mapped cache
+    // file). owner must keep every pointer valid for as long as the series and
+    // its copies exist.
+    static PriceSeries FromColumns(std::shared_ptr<const void> owner, size_t size,
+                                   const double* open, const double* high,
+                                   const double* low, const double* close,
+                                   const double* volume, const int32_t* dates) {
+        PriceSeries s;
+        s.storage_ = std::move(owner);
+        s.size_ = size;
+        s.open_ = open;
+        s.high_ = high;
+        s.low_ = low;
+        s.close_ = close;
+        s.volume_ = volume;
+        s.dates_ = dates;
+        return s;
+    }
+
+    // Owner of the column memory (shared by copies and slices); null for an
+    // empty series. Caches use it to tell series apart without keeping them
+    // alive.
+    const std::shared_ptr<const void>& Storage() const { return storage_; }
+
+    // Zero-copy view of bars [begin, end)
+    PriceSeries Slice(size_t begin, size_t end) const {
+        PriceSeries s(*this);
+        s.size_ = end - begin;
+        s.open_ += begin;
+        s.high_ += begin;
+        s.low_ += begin;
+        s.close_ += begin;
+        s.volume_ += begin;
+        s.dates_ += begin;
+        return s;
+    }
+
+private:
+    friend class PriceSeriesBuilder;
+
+    std::shared_ptr<const void> storage_;  // keeps the columns alive
+    size_t size_ = 0;
+    const double* open_ = nullptr;
+    const double* high_ = nullptr;
+    const double* low_ = nullptr;
+    const double* close_ = nullptr;
+    const double* volume_ = nullptr;
+    const int32_t* dates_ = nullptr;
+};
+
+// Accumulates bars column by column and hands the columns over to a PriceSeries
+class PriceSeriesBuilder {
+public:
+    PriceSeriesBuilder() : cols_(std::make_shared<Columns>()) {}
+
+    void Reserve(size_t rows) {
+        cols_->open.reserve(rows);
+        cols_->high.reserve(rows);
+        cols_->low.reserve(rows);
+        cols_->close.reserve(rows);
+        cols_->volume.reserve(rows);
+        cols_->dates.reserve(rows);
+    }
+
+    void Append(int32_t date, double open, double high, double low,
+                double close, double volume) {
+        cols_->open.push_back(open);
+        cols_->high.push_back(high);
+        cols_->low.push_back(low);
+        cols_->close.push_back(close);
+        cols_->volume.push_back(volume);
+        cols_->dates.push_back(date);
+    }
+
+    size_t size() const { return cols_->close.size(); }
+
+    // Finish building; the builder is reset and may be reused afterwards
+    PriceSeries Build() {
+        PriceSeries s;
+        s.size_ = cols_->close.size();
+        s.open_ = cols_->open.data();
+        s.high_ = cols_->high.data();
+        s.low_ = cols_->low.data();
+        s.close_ = cols_->close.data();
+        s.volume_ = cols_->volume.data();
+        s.dates_ = cols_->dates.data();
+        s.storage_ = std::move(cols_);
+
+        cols_ = std::make_shared<Columns>();
+        return s;
+    }
+
+private:
+    struct Columns {
+        AlignedColumn open, high, low, close, volume;
+        std::vector<int32_t, AlignedAllocator<int32_t>> dates;
+    };
+    std::shared_ptr<Columns> cols_;
+};
+
+inline PriceSeries::PriceSeries(const std::vector<StockData>& bars) {
+    PriceSeriesBuilder builder;
+    builder.Reserve(bars.size());
+    for (const auto& bar : bars) {
+        builder.Append(bar.date, bar.open, bar.high, bar.low, bar.close, bar.volume);
+    }
+    *this = builder.Build();
+}
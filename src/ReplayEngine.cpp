@@ -0,0 +1,220 @@
+#include "ReplayEngine.h"
+#include "TradingDate.h"
+#include "UnixSocket.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t Nanos(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+void AppendNumber(std::string& out, double value) {
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+// Encode one bar in the stream protocol (the binary magic is sent once,
+// ahead of the first day; RunReplay has checked the tickers fit)
+void AppendBar(std::string& out, const ReplaySource& source, size_t row, bool lineProtocol) {
+    const PriceSeries& s = source.series;
+    if (lineProtocol) {
+        char date[10];
+        FormatDate(s.Date(row), date);
+        out += source.ticker;
+        out += ',';
+        out.append(date, sizeof(date));
+        for (double value : { s.Open()[row], s.High()[row], s.Low()[row], s.Close()[row], s.Volume()[row] }) {
+            out += ',';
+            AppendNumber(out, value);
+        }
+        out += '\n';
+        return;
+    }
+    StreamBarRecord record{};
+    std::memcpy(record.ticker, source.ticker.data(), std::min(source.ticker.size(), sizeof(record.ticker)));
+    record.date = s.Date(row);
+    record.open = s.Open()[row];
+    record.high = s.High()[row];
+    record.low = s.Low()[row];
+    record.close = s.Close()[row];
+    record.volume = s.Volume()[row];
+    out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+} // namespace
+
+std::vector<ReplaySource> SyntheticSources(size_t tickers, size_t bars, uint64_t seed) {
+    int32_t firstDay = 0;
+    ParseDate("2000-01-03", firstDay);
+    const double dt = 1.0 / 252.0;
+
+    std::vector<ReplaySource> sources;
+    sources.reserve(tickers);
+    for (size_t t = 0; t < tickers; ++t) {
+        // Each ticker has its own generator, so adding tickers leaves the
+        // earlier ones unchanged
+        std::mt19937_64 rng(seed * 1000003 + t);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        const double drift = -0.05 + 0.30 * uniform(rng);
+        const double sigma = 0.15 + 0.45 * uniform(rng);
+        const double step = sigma * std::sqrt(dt);
+        double close = 20.0 + 180.0 * uniform(rng);
+
+        PriceSeriesBuilder builder;
+        builder.Reserve(bars);
+        int32_t day = firstDay;
+        for (size_t i = 0; i < bars; ++i, ++day) {
+            // 1970-01-01 was a Thursday: (day + 4) % 7 is 0 on Sundays
+            while ((day + 4) % 7 == 0 || (day + 4) % 7 == 6) ++day;
+            double open = close;
+            close = open * std::exp((drift - 0.5 * sigma * sigma) * dt + step * normal(rng));
+            double high = std::max(open, close) * (1.0 + 0.5 * step * std::fabs(normal(rng)));
+            double low = std::min(open, close) * (1.0 - 0.5 * step * std::fabs(normal(rng)));
+            double volume = std::round(1e6 * std::exp(0.5 * normal(rng)));
+            builder.Append(day, open, high, low, close, volume);
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "SYN%05zu", t + 1);
+        sources.push_back({ name, builder.Build() });
+    }
+    return sources;
+}
+
+std::vector<ReplayBar> MergeSources(const std::vector<ReplaySource>& sources) {
+    size_t total = 0;
+    for (const ReplaySource& source : sources) total += source.series.size();
+
+    // k-way merge: the heap holds the next bar of every unfinished source
+    auto later = [](const ReplayBar& a, const ReplayBar& b) {
+        return a.date != b.date ? a.date > b.date : a.source > b.source;
+    };
+    std::priority_queue<ReplayBar, std::vector<ReplayBar>, decltype(later)> next(later);
+    for (size_t s = 0; s < sources.size(); ++s) {
+        if (!sources[s].series.empty()) {
+            next.push({ sources[s].series.Date(0), static_cast<uint32_t>(s), 0 });
+        }
+    }
+
+    std::vector<ReplayBar> merged;
+    merged.reserve(total);
+    while (!next.empty()) {
+        ReplayBar bar = next.top();
+        next.pop();
+        merged.push_back(bar);
+        const PriceSeries& series = sources[bar.source].series;
+        if (bar.row + 1 < series.size()) {
+            next.push({ series.Date(bar.row + 1), bar.source, bar.row + 1 });
+        }
+    }
+    return merged;
+}
+
+ReplayReport RunReplay(const std::vector<ReplaySource>& sources, const ReplayOptions& options,
+                       StreamEngine& engine) {
+    ReplayReport report;
+    report.tickers = sources.size();
+    const std::vector<ReplayBar> bars = MergeSources(sources);
+    const size_t n = bars.size();
+    report.bars = n;
+    if (n == 0) {
+        report.error = "nothing to replay";
+        return report;
+    }
+
+    // A binary record holds 8 ticker bytes; a longer ticker would arrive
+    // truncated, and two tickers sharing a prefix would merge into one
+    if (!options.lineProtocol) {
+        for (const ReplaySource& source : sources) {
+            if (source.ticker.size() > sizeof(StreamBarRecord::ticker)) {
+                report.error = "ticker '" + source.ticker + "' is longer than the binary protocol's " +
+                               std::to_string(sizeof(StreamBarRecord::ticker)) +
+                               " characters; replay it with the line protocol";
+                return report;
+            }
+        }
+    }
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        report.error = std::string("socketpair: ") + std::strerror(errno);
+        return report;
+    }
+
+    // Release time of every bar (steady clock, ns), stored by the producer
+    // before the bytes are written and read by the consumer once the engine
+    // has finished the bar
+    std::unique_ptr<std::atomic<int64_t>[]> released(new std::atomic<int64_t>[n]);
+    std::vector<float> endToEndUs;
+    endToEndUs.reserve(n);
+    size_t processed = 0;
+    engine.SetBarHandler([&](bool) {
+        if (processed == n) return;
+        int64_t latency = Nanos(Clock::now()) - released[processed++].load(std::memory_order_acquire);
+        endToEndUs.push_back(static_cast<float>(static_cast<double>(latency) / 1000.0));
+    });
+
+    const Clock::time_point start = Clock::now();
+    size_t days = 0;
+    std::thread producer([&] {
+        std::string out;
+        if (!options.lineProtocol) out.append(kStreamBinaryMagic, sizeof(kStreamBinaryMagic));
+        const int32_t firstDate = bars.front().date;
+        for (size_t i = 0; i < n;) {
+            size_t end = i;
+            while (end < n && bars[end].date == bars[i].date) ++end;
+
+            Clock::time_point release;
+            if (options.speed > 0.0) {
+                double offset = (bars[i].date - firstDate) * 86400.0 / options.speed;
+                release = start + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(offset));
+                std::this_thread::sleep_until(release);
+            } else {
+                release = Clock::now();
+            }
+
+            for (size_t k = i; k < end; ++k) {
+                released[k].store(Nanos(release), std::memory_order_release);
+                AppendBar(out, sources[bars[k].source], bars[k].row, options.lineProtocol);
+            }
+            if (!SendAll(fds[0], out)) break;
+            out.clear();
+            ++days;
+            i = end;
+        }
+        ::shutdown(fds[0], SHUT_WR);
+    });
+
+    RunStream(engine, fds[1]);
+    producer.join();
+    const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    ::close(fds[0]);
+    ::close(fds[1]);
+    engine.SetBarHandler(nullptr);
+
+    report.days = days;
+    report.wallSeconds = wall;
+    report.barsPerSecond = wall > 0.0 ? static_cast<double>(processed) / wall : 0.0;
+    report.endToEndUs = SummarizeLatencies(endToEndUs);
+    report.engine = engine.Stats();
+    if (processed != n) report.error = "only " + std::to_string(processed) + " bars arrived";
+    return report;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PriceSeries.h"
+#include "StreamEngine.h"
+
+// Historical market replay (`stocks --replay`): a reproducible load test of
+// the streaming ingestion and signal path.
+//
+// Any number of series (bundled CSVs, synthetic geometric Brownian motion
+// sets) are merged into one time-ordered bar stream. A producer thread
+// encodes each trading day's bars in the stream protocol (StreamEngine.h)
+// and writes them over a Unix socket pair; the calling thread decodes them
+// with StreamDecoder into a StreamEngine, exactly as `stocks --stream` does.
+//
+// Paced replays release each day when the accelerated clock reaches it;
+// otherwise the producer runs as fast as the consumer keeps up. End-to-end
+// latency runs from a bar's release (its scheduled time when paced, the
+// moment it is written otherwise) to the engine finishing it, so socket
+// queueing, decoding and any lag behind the schedule all count. Unpaced,
+// the producer keeps the socket full, so that latency mostly measures the
+// backlog; barsPerSecond is the figure of interest there.
+
+struct ReplaySource {
+    std::string ticker;            // at most 8 characters for the binary protocol
+    PriceSeries series;
+};
+
+// One bar of the merged stream
+struct ReplayBar {
+    int32_t date;
+    uint32_t source;               // index into the sources
+    uint32_t row;                  // bar within that source's series
+};
+
+// tickers synthetic series of bars weekdays each, from 2000-01-03, following
+// geometric Brownian motion with per-ticker drift and volatility. The same
+// seed gives the same data. Tickers are named SYN00001, SYN00002, ...
+std::vector<ReplaySource> SyntheticSources(size_t tickers, size_t bars, uint64_t seed = 1);
+
+// All bars of sources ordered by date, ties in source order
+std::vector<ReplayBar> MergeSources(const std::vector<ReplaySource>& sources);
+
+struct ReplayOptions {
+    // Market time per wall-clock time, one trading day being 86400 market
+    // seconds (86400 replays a day per second); 0 = as fast as possible
+    double speed = 0.0;
+    bool lineProtocol = false;     // line protocol instead of binary records
+};
+
+struct ReplayReport {
+    size_t bars = 0;               // sent
+    size_t tickers = 0;
+    size_t days = 0;               // distinct dates, i.e. producer writes
+    double wallSeconds = 0.0;
+    double barsPerSecond = 0.0;
+    LatencySummary endToEndUs;     // release to processed, per bar
+    StreamStats engine;            // engine-only latency, events, rejections
+    std::string error;             // set if the replay could not run
+};
+
+// Replay sources into engine and measure it. engine keeps its state
+// afterwards, so snapshots can be compared against batch results. A binary
+// replay with a ticker longer than 8 characters fails with an error before
+// anything is sent.
+ReplayReport RunReplay(const std::vector<ReplaySource>& sources, const ReplayOptions& options,
+                       StreamEngine& engine);
@@ -0,0 +1,167 @@
+#include "ReportFormat.h"
+#include "JsonWriter.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t kScalars = 15;
+constexpr size_t kHeaderBytes = 32;
+constexpr size_t kSeriesColumns = 8;
+
+size_t PadTo8(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+// Writes fields at a cursor into space the caller has already sized
+class RecordWriter {
+public:
+    explicit RecordWriter(char* at) : at_(at) {}
+
+    template <typename T>
+    void Put(T value) {
+        std::memcpy(at_, &value, sizeof(T));
+        at_ += sizeof(T);
+    }
+
+    void PutString(const std::string& s) {
+        Put(static_cast<uint32_t>(s.size()));
+        std::memcpy(at_, s.data(), s.size());
+        at_ += s.size();
+    }
+
+    // Zeroes up to the next multiple of 8 from begin
+    void Align(const char* begin) {
+        size_t used = static_cast<size_t>(at_ - begin);
+        size_t pad = PadTo8(used) - used;
+        std::memset(at_, 0, pad);
+        at_ += pad;
+    }
+
+private:
+    char* at_;
+};
+
+double At(const std::vector<double>& values, size_t i) {
+    return i < values.size() ? values[i] : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // namespace
+
+bool ParseOutputFormat(const std::string& name, OutputFormat& format) {
+    if (name == "text") format = OutputFormat::Text;
+    else if (name == "json") format = OutputFormat::Json;
+    else if (name == "bin") format = OutputFormat::Binary;
+    else return false;
+    return true;
+}
+
+void AppendAnalysisBinary(const TickerAnalysis& analysis, bool includeSeries, std::string& out) {
+    const PriceSeries& data = analysis.load.series;
+    const IndicatorResults& ind = analysis.indicators;
+    const bool failed = analysis.load.status != LoadStatus::Ok || data.empty();
+    const std::vector<StrategyPerformance>& ranking = analysis.evaluation.ranking;
+
+    const size_t rows = failed ? 0 : data.size();
+    const size_t strategies = failed ? 0 : ranking.size();
+    const size_t lags = failed ? 0 : ind.autocorrelation.acf.size();
+    const bool series = includeSeries && !failed;
+    const size_t last = rows > 0 ? rows - 1 : 0;
+    const double close = rows > 0 ? data.Close()[last] : std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<std::string> strings;
+    if (failed) {
+        strings = { analysis.ticker,
+                    analysis.load.error.empty() ? "no data for " + analysis.ticker : analysis.load.error };
+    } else {
+        strings = { analysis.ticker, analysis.load.source,
+                    BollingerStatus(close, At(ind.bollingerMiddle, last), At(ind.bollingerUpper, last),
+                                    At(ind.bollingerLower, last)),
+                    HurstBehavior(ind.hurst),
+                    analysis.evaluation.best ? analysis.evaluation.bestPerformance.strategyName : "",
+                    std::isnan(analysis.signal) ? "" : SignalAction(analysis.signal) };
+        for (const StrategyPerformance& perf : ranking) strings.push_back(perf.strategyName);
+    }
+
+    // Exact record size, so the buffer grows once
+    size_t size = kHeaderBytes + sizeof(double) * (kScalars + lags + strategies * 5);
+    if (series) {
+        size += PadTo8(sizeof(int32_t) * rows);
+        size += sizeof(double) * rows * kSeriesColumns;
+    }
+    for (const std::string& s : strings) size += sizeof(uint32_t) + s.size();
+    size = PadTo8(size);
+
+    const size_t offset = out.size();
+    out.resize(offset + size);
+    char* begin = &out[offset];
+    RecordWriter w(begin);
+
+    for (char c : kReportMagic) w.Put(c);
+    w.Put(kReportVersion);
+    w.Put(static_cast<uint16_t>((series ? kReportSeries : 0) | (failed ? kReportFailed : 0)));
+    w.Put(static_cast<uint32_t>(size));
+    w.Put(static_cast<uint32_t>(rows));
+    w.Put(rows > 0 ? data.Date(last) : int32_t(0));
+    w.Put(static_cast<uint32_t>(strategies));
+    w.Put(static_cast<uint32_t>(lags));
+    w.Put(kScalars);
+
+    if (failed) {
+        for (uint32_t k = 0; k < kScalars; ++k) w.Put(std::numeric_limits<double>::quiet_NaN());
+    } else {
+        for (double value : { close, At(ind.sma, last), At(ind.volatility, last),
+                              ind.stats.mean, ind.stats.stddev, ind.stats.max, ind.stats.min,
+                              ind.sharpe, ind.periodReturn, ind.maxDrawdown,
+                              At(ind.bollingerMiddle, last), At(ind.bollingerUpper, last),
+                              At(ind.bollingerLower, last), ind.hurst, analysis.signal }) {
+            w.Put(value);
+        }
+        for (size_t k = 0; k < lags; ++k) w.Put(ind.autocorrelation.acf[k]);
+        for (const StrategyPerformance& perf : ranking) {
+            w.Put(perf.totalReturn);
+            w.Put(perf.sharpeRatio);
+            w.Put(perf.maxDrawdown);
+            w.Put(perf.winRate);
+            w.Put(perf.score);
+        }
+    }
+
+    if (series) {
+        for (size_t i = 0; i < rows; ++i) w.Put(data.Date(i));
+        w.Align(begin);
+        for (double value : data.Close()) w.Put(value);
+        for (double value : data.Volume()) w.Put(value);
+        for (const std::vector<double>* column : { &ind.returns, &ind.sma, &ind.volatility,
+                                                    &ind.bollingerMiddle, &ind.bollingerUpper,
+                                                    &ind.bollingerLower }) {
+            for (size_t i = 0; i < rows; ++i) w.Put(At(*column, i));
+        }
+    }
+
+    for (const std::string& s : strings) w.PutString(s);
+    w.Align(begin);
+}
+
+void AppendAnalysis(const TickerAnalysis& analysis, OutputFormat format, bool includeSeries,
+                    std::string& out) {
+    if (format == OutputFormat::Binary) {
+        AppendAnalysisBinary(analysis, includeSeries, out);
+        return;
+    }
+    if (format != OutputFormat::Json) return;
+
+    // Serialize in place at the end of out rather than into a temporary
+    JsonWriter json(std::move(out));
+    if (analysis.load.status != LoadStatus::Ok || analysis.load.series.empty()) {
+        json.BeginObject()
+            .Key("ticker").String(analysis.ticker)
+            .Key("error").String(analysis.load.error.empty() ? "no data for " + analysis.ticker
+                                                             : analysis.load.error)
+            .EndObject();
+    } else {
+        json.Reserve(AnalysisJsonSizeHint(analysis, includeSeries));
+        WriteAnalysisJson(json, analysis, includeSeries);
+    }
+    out = json.Take();
+    out += '\n';
+}
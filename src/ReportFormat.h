@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Universe.h"
+
+// Output formats of the stocks binary (--format=text|json|bin).
+//
+// text  the human-readable report (default)
+// json  AnalysisJson: one JSON object per ticker and line
+// bin   the binary record below, one per ticker, back to back
+//
+// --series adds the full per-bar columns (dates, close, volume, returns, SMA,
+// volatility, Bollinger bands) to the json and bin outputs.
+enum class OutputFormat { Text, Json, Binary };
+
+// "text", "json" or "bin"; false for anything else
+bool ParseOutputFormat(const std::string& name, OutputFormat& format);
+
+// Binary report record, version 1. Every field is in host byte order (little
+// endian on every platform we build for; a reader seeing a byte-swapped magic
+// knows). All numeric blocks start on 8-byte boundaries, so a reader can view
+// them in place (numpy.frombuffer with an offset).
+//
+//   offset  type        field
+//   0       char[4]     magic "SSRB"
+//   4       uint16      version (1)
+//   6       uint16      flags: 1 = series present, 2 = load failed
+//   8       uint32      record size in bytes (a multiple of 8)
+//   12      uint32      rows: bars in the series
+//   16      int32       latest date, days since 1970-01-01 (0 without bars)
+//   20      uint32      S: strategies in the backtest table
+//   24      uint32      L: autocorrelation lags
+//   28      uint32      K: scalars (15 in version 1)
+//   32      double[K]   latestClose, sma20, volatility20, returnMean,
+//                       returnStddev, returnMax, returnMin, sharpe,
+//                       periodReturn, maxDrawdown, bollingerMiddle,
+//                       bollingerUpper, bollingerLower, hurst, signal
+//           double[L]   autocorrelation at lags 1..L
+//           double[S*5] per strategy, in ranking order: totalReturn, sharpe,
+//                       maxDrawdown, winRate, score
+//           only with flags & 1:
+//             int32[rows]   dates, then zero padding to 8 bytes
+//             double[rows] x 8  close, volume, return, sma20, volatility20,
+//                       bollingerMiddle, bollingerUpper, bollingerLower
+//           strings, each uint32 length + UTF-8 bytes: ticker, source,
+//                       Bollinger status, Hurst behavior, recommended
+//                       strategy, action, then the S strategy names
+//           zero padding to 8 bytes
+//
+// Missing values are NaN. A failed load has flags 2, no bars, S = L = 0,
+// all-NaN scalars and the strings ticker and error message only.
+constexpr char kReportMagic[4] = { 'S', 'S', 'R', 'B' };
+constexpr uint16_t kReportVersion = 1;
+constexpr uint16_t kReportSeries = 1;
+constexpr uint16_t kReportFailed = 2;
+
+// Append analysis as one binary record to out. The record's exact size is
+// computed first, so out grows once and every field is written in place.
+void AppendAnalysisBinary(const TickerAnalysis& analysis, bool includeSeries, std::string& out);
+
+// Append analysis in format (json: one line; text is not supported here
+// and appends nothing). Failed loads become {"ticker":...,"error":...}.
+void AppendAnalysis(const TickerAnalysis& analysis, OutputFormat format, bool includeSeries,
+                    std::string& out);
@@ -0,0 +1,55 @@
+#pragma once
+#include <cmath>
+#include <limits>
+
+// Mean and variance of a sliding window, updated in O(1) per value.
+//
+// Uses Welford's recurrence for both directions, which avoids the catastrophic
+// cancellation of the sum / sum-of-squares form. Removal still accumulates
+// rounding error over very long runs, so callers sliding across long series
+// should Reset() and re-add the live window every so often.
+class RollingMoments {
+public:
+    void Add(double x) {
+        ++count_;
+        double delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (x - mean_);
+    }
+
+    void Remove(double x) {
+        if (count_ <= 1) {
+            Reset();
+            return;
+        }
+        --count_;
+        double delta = x - mean_;
+        mean_ -= delta / count_;
+        m2_ -= delta * (x - mean_);
+        if (m2_ < 0.0) m2_ = 0.0;  // guard against tiny negatives
+    }
+
+    void Reset() {
+        count_ = 0;
+        mean_ = 0.0;
+        m2_ = 0.0;
+    }
+
+    int count() const { return count_; }
+    double mean() const { return count_ > 0 ? mean_ : std::numeric_limits<double>::quiet_NaN(); }
+
+    // Sample variance (n - 1 denominator); NaN with fewer than two values
+    double SampleVariance() const {
+        return count_ > 1 ? m2_ / (count_ - 1) : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Population variance (n denominator); NaN when empty
+    double PopulationVariance() const {
+        return count_ > 0 ? m2_ / count_ : std::numeric_limits<double>::quiet_NaN();
+    }
+
+private:
+    int count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
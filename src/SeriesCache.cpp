@@ -0,0 +1,211 @@
+#include "SeriesCache.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[4] = { 'S', 'S', 'B', '\0' };
+constexpr uint32_t kEndianTag = 0x01020304;
+constexpr uint64_t kAlignment = 64;
+
+struct SsbHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t reserved;
+    uint64_t rowCount;
+
+    // Identity of the CSV this sidecar was built from
+    uint64_t sourceSize;
+    int64_t sourceMtimeNs;
+    uint64_t sourceHash;
+
+    // Byte offsets of each column from the start of the file
+    uint64_t openOffset;
+    uint64_t highOffset;
+    uint64_t lowOffset;
+    uint64_t closeOffset;
+    uint64_t volumeOffset;
+    uint64_t datesOffset;
+};
+
+bool StatSource(const std::string& path, SeriesCache::SourceIdentity& info) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return false;
+    info.size = static_cast<uint64_t>(st.st_size);
+    info.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// FNV-1a over 8-byte words (with a byte-wise tail); only needs to detect edits
+uint64_t HashBytes(const char* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    const uint64_t prime = 1099511628211ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return h;
+}
+
+bool HashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    hash = HashBytes(file.data(), file.size());
+    return true;
+}
+
+uint64_t AlignUp(uint64_t offset) {
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+bool InBounds(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+    return offset % kAlignment == 0 && offset <= fileSize && bytes <= fileSize - offset;
+}
+
+void WritePadding(std::ofstream& out, uint64_t& pos, uint64_t target) {
+    static const char zeros[kAlignment] = {};
+    out.write(zeros, static_cast<std::streamsize>(target - pos));
+    pos = target;
+}
+
+} // namespace
+
+SeriesCache::SourceIdentity SeriesCache::Identify(const MappedFile& csv) {
+    SourceIdentity source;
+    source.size = csv.size();
+    source.mtimeNs = csv.mtimeNs();
+    source.hash = HashBytes(csv.data(), csv.size());
+    return source;
+}
+
+std::string SeriesCache::SidecarPath(const std::string& csvPath) {
+    size_t slash = csvPath.find_last_of('/');
+    size_t dot = csvPath.find_last_of('.');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        return csvPath.substr(0, dot) + ".ssb";
+    }
+    return csvPath + ".ssb";
+}
+
+bool SeriesCache::Load(const std::string& csvPath, PriceSeries& out) {
+    SourceIdentity source;
+    if (!StatSource(csvPath, source)) return false;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(SidecarPath(csvPath)) || file->size() < sizeof(SsbHeader)) return false;
+
+    SsbHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kVersion || header.endianTag != kEndianTag) {
+        return false;
+    }
+
+    if (header.sourceSize != source.size) return false;
+    if (header.sourceMtimeNs != source.mtimeNs) {
+        uint64_t hash;
+        if (!HashFile(csvPath, hash) || hash != header.sourceHash) return false;
+    }
+
+    // rowCount comes from the file: bound it before any size is computed
+    // from it, so a corrupt count cannot wrap around to a small column size
+    const uint64_t rows = header.rowCount;
+    const uint64_t fileSize = file->size();
+    if (rows > fileSize / sizeof(double)) return false;
+    const uint64_t columnBytes = rows * sizeof(double);
+    if (!InBounds(header.openOffset, columnBytes, fileSize) ||
+        !InBounds(header.highOffset, columnBytes, fileSize) ||
+        !InBounds(header.lowOffset, columnBytes, fileSize) ||
+        !InBounds(header.closeOffset, columnBytes, fileSize) ||
+        !InBounds(header.volumeOffset, columnBytes, fileSize) ||
+        !InBounds(header.datesOffset, rows * sizeof(int32_t), fileSize)) {
+        return false;
+    }
+
+    const char* base = file->data();
+
+    out = PriceSeries::FromColumns(
+        file, static_cast<size_t>(rows),
+        reinterpret_cast<const double*>(base + header.openOffset),
+        reinterpret_cast<const double*>(base + header.highOffset),
+        reinterpret_cast<const double*>(base + header.lowOffset),
+        reinterpret_cast<const double*>(base + header.closeOffset),
+        reinterpret_cast<const double*>(base + header.volumeOffset),
+        reinterpret_cast<const int32_t*>(base + header.datesOffset));
+    return true;
+}
+
+bool SeriesCache::Store(const std::string& csvPath, const SourceIdentity& source,
+                        const PriceSeries& series) {
+    const uint64_t rows = series.size();
+
+    SsbHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.endianTag = kEndianTag;
+    header.rowCount = rows;
+    header.sourceSize = source.size;
+    header.sourceMtimeNs = source.mtimeNs;
+    header.sourceHash = source.hash;
+
+    const uint64_t columnBytes = rows * sizeof(double);
+    header.openOffset = AlignUp(sizeof(SsbHeader));
+    header.highOffset = AlignUp(header.openOffset + columnBytes);
+    header.lowOffset = AlignUp(header.highOffset + columnBytes);
+    header.closeOffset = AlignUp(header.lowOffset + columnBytes);
+    header.volumeOffset = AlignUp(header.closeOffset + columnBytes);
+    header.datesOffset = AlignUp(header.volumeOffset + columnBytes);
+
+    const std::string path = SidecarPath(csvPath);
+    // Threads of one process may store the same ticker at once (a server
+    // reloading it, a universe naming it twice): each writes its own file
+    static std::atomic<uint64_t> storeCount{0};
+    const std::string tmpPath = path + ".tmp" + std::to_string(::getpid()) + "." +
+                                std::to_string(storeCount.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        uint64_t pos = 0;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pos += sizeof(header);
+
+        const PriceColumn columns[] = { series.Open(), series.High(), series.Low(),
+                                        series.Close(), series.Volume() };
+        const uint64_t offsets[] = { header.openOffset, header.highOffset, header.lowOffset,
+                                     header.closeOffset, header.volumeOffset };
+        for (int c = 0; c < 5; ++c) {
+            WritePadding(out, pos, offsets[c]);
+            out.write(reinterpret_cast<const char*>(columns[c].data()),
+                      static_cast<std::streamsize>(columnBytes));
+            pos += columnBytes;
+        }
+
+        WritePadding(out, pos, header.datesOffset);
+        out.write(reinterpret_cast<const char*>(series.Dates().data()),
+                  static_cast<std::streamsize>(rows * sizeof(int32_t)));
+
+        if (!out) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include "PriceSeries.h"
+
+class MappedFile;
+
+// Binary columnar sidecar for a price CSV (e.g. NVDA.csv -> NVDA.ssb).
+//
+// The first load of a CSV writes its parsed columns next to it; later loads map
+// the sidecar and hand its columns to a PriceSeries without copying or parsing.
+// A sidecar is only used while it still matches its source file: size and
+// modification time are checked on every load, and when only the timestamp
+// differs (a touched or copied file) a content hash decides.
+//
+// File layout (native endianness, every column 64-byte aligned):
+//   SsbHeader
+//   double   open[rows], high[rows], low[rows], close[rows], volume[rows]
+//   int32_t  dates[rows]   (days since 1970-01-01)
+class SeriesCache {
+public:
+    // 2: dates stored as int32 epoch days instead of packed text
+    static constexpr uint32_t kVersion = 2;
+
+    // What a sidecar records about its CSV: size and modification time of
+    // the file as opened, and a hash of its bytes
+    struct SourceIdentity {
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;
+        uint64_t hash = 0;
+    };
+
+    static std::string SidecarPath(const std::string& csvPath);
+
+    // Identity of the CSV as mapped in csv. Take it from the mapping the
+    // parser reads, so the identity and the columns describe the same bytes.
+    static SourceIdentity Identify(const MappedFile& csv);
+
+    // Map the sidecar for csvPath into out. Returns false if it is missing,
+    // stale, or malformed.
+    static bool Load(const std::string& csvPath, PriceSeries& out);
+
+    // Write the sidecar for csvPath, whose contents as identified by source
+    // were parsed into series. The file is written under a name unique to
+    // this call and renamed into place, so concurrent readers never see a
+    // partial file and concurrent writers never share one. Returns false if
+    // it could not be written (e.g. read-only directory).
+    static bool Store(const std::string& csvPath, const SourceIdentity& source,
+                      const PriceSeries& series);
+};
@@ -0,0 +1,431 @@
+#include "SimdKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STOCKSENSE_X86 1
+#endif
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+// ------------------- Scalar references -------------------
+
+void ReturnsScalar(const double* close, size_t n, double* out) {
+    if (n == 0) return;
+    out[0] = kNaN;
+    for (size_t i = 1; i < n; ++i) {
+        out[i] = (close[i - 1] == 0.0) ? kNaN : (close[i] - close[i - 1]) / close[i - 1];
+    }
+}
+
+ColumnReduction ReduceScalar(const double* values, size_t n) {
+    ColumnReduction r = { 0.0, 0.0, kInf, -kInf, 0 };
+    for (size_t i = 0; i < n; ++i) {
+        double v = values[i];
+        if (std::isnan(v)) continue;
+        r.sum += v;
+        r.sumSq += v * v;
+        r.min = std::min(r.min, v);
+        r.max = std::max(r.max, v);
+        ++r.count;
+    }
+    return r;
+}
+
+void SlidingMeanScalar(const double* values, size_t n, int window, double* out) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += values[i];
+        if (window > 0 && i >= static_cast<size_t>(window)) {
+            sum -= values[i - window];
+        }
+        out[i] = (window > 0 && i + 1 >= static_cast<size_t>(window)) ? sum / window : kNaN;
+    }
+}
+
+double MaxDrawdownScalar(const double* values, size_t n) {
+    if (n == 0) return kNaN;
+    double peak = values[0];
+    double maxDrawdown = 0.0;
+    for (size_t i = 1; i < n; ++i) {
+        double price = values[i];
+        if (price > peak) peak = price;
+        if (peak > 0.0) {
+            double drawdown = (price - peak) / peak;
+            if (drawdown < maxDrawdown) maxDrawdown = drawdown;
+        }
+    }
+    return maxDrawdown;
+}
+
+#ifdef STOCKSENSE_X86
+
+// ------------------- SSE2 (2 lanes) -------------------
+
+namespace {
+
+void ReturnsSSE2(const double* close, size_t n, double* out) {
+    if (n == 0) return;
+    out[0] = kNaN;
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d nan = _mm_set1_pd(kNaN);
+    size_t i = 1;
+    for (; i + 2 <= n; i += 2) {
+        __m128d cur = _mm_loadu_pd(close + i);
+        __m128d prev = _mm_loadu_pd(close + i - 1);
+        __m128d r = _mm_div_pd(_mm_sub_pd(cur, prev), prev);
+        __m128d isZero = _mm_cmpeq_pd(prev, zero);
+        r = _mm_or_pd(_mm_and_pd(isZero, nan), _mm_andnot_pd(isZero, r));
+        _mm_storeu_pd(out + i, r);
+    }
+    for (; i < n; ++i) {
+        out[i] = (close[i - 1] == 0.0) ? kNaN : (close[i] - close[i - 1]) / close[i - 1];
+    }
+}
+
+ColumnReduction ReduceSSE2(const double* values, size_t n) {
+    const __m128d one = _mm_set1_pd(1.0);
+    __m128d sum = _mm_setzero_pd(), sumSq = _mm_setzero_pd(), count = _mm_setzero_pd();
+    __m128d mn = _mm_set1_pd(kInf), mx = _mm_set1_pd(-kInf);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d valid = _mm_cmpord_pd(x, x);
+        __m128d xv = _mm_and_pd(x, valid);  // NaN -> 0
+        sum = _mm_add_pd(sum, xv);
+        sumSq = _mm_add_pd(sumSq, _mm_mul_pd(xv, xv));
+        count = _mm_add_pd(count, _mm_and_pd(valid, one));
+        mn = _mm_min_pd(x, mn);  // keeps mn when x is NaN
+        mx = _mm_max_pd(x, mx);
+    }
+
+    alignas(16) double s[2], q[2], c[2], lo[2], hi[2];
+    _mm_store_pd(s, sum);
+    _mm_store_pd(q, sumSq);
+    _mm_store_pd(c, count);
+    _mm_store_pd(lo, mn);
+    _mm_store_pd(hi, mx);
+
+    ColumnReduction tail = ReduceScalar(values + i, n - i);
+    ColumnReduction r;
+    r.sum = s[0] + s[1] + tail.sum;
+    r.sumSq = q[0] + q[1] + tail.sumSq;
+    r.min = std::min({ lo[0], lo[1], tail.min });
+    r.max = std::max({ hi[0], hi[1], tail.max });
+    r.count = static_cast<size_t>(c[0] + c[1]) + tail.count;
+    return r;
+}
+
+// Values leaving the window for the block starting at i: values[k - window]
+// for lanes with k >= window, zero for lanes still filling the first window.
+// Only the one block that straddles the boundary needs the gather.
+template <size_t Lanes>
+inline void LeavingValues(const double* values, size_t i, size_t w, double* leaving) {
+    for (size_t l = 0; l < Lanes; ++l) {
+        leaving[l] = (i + l >= w) ? values[i + l - w] : 0.0;
+    }
+}
+
+// Sliding sum as an inclusive prefix scan of d[i] = x[i] - x[i-window]
+void SlidingMeanSSE2(const double* values, size_t n, int window, double* out) {
+    if (window <= 0) {
+        std::fill(out, out + n, kNaN);
+        return;
+    }
+    const size_t w = static_cast<size_t>(window);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d invW = _mm_set1_pd(1.0 / window);
+    __m128d carry = zero;
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        if (i >= w) {
+            v = _mm_sub_pd(v, _mm_loadu_pd(values + i - w));
+        } else if (i + 2 > w) {
+            alignas(16) double leaving[2];
+            LeavingValues<2>(values, i, w, leaving);
+            v = _mm_sub_pd(v, _mm_load_pd(leaving));
+        }
+        v = _mm_add_pd(v, _mm_unpacklo_pd(zero, v));  // [a, a+b]
+        v = _mm_add_pd(v, carry);
+        carry = _mm_unpackhi_pd(v, v);
+        _mm_storeu_pd(out + i, _mm_mul_pd(v, invW));
+    }
+
+    double sum = _mm_cvtsd_f64(carry);
+    for (; i < n; ++i) {
+        sum += values[i];
+        if (i >= w) sum -= values[i - w];
+        out[i] = sum / window;
+    }
+    std::fill(out, out + std::min(n, w - 1), kNaN);
+}
+
+double MaxDrawdownSSE2(const double* values, size_t n) {
+    if (n == 0) return kNaN;
+    if (std::isnan(values[0])) return MaxDrawdownScalar(values, n);
+
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d negInf = _mm_set1_pd(-kInf);
+    __m128d peakCarry = _mm_set1_pd(values[0]);
+    __m128d worst = zero;
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d valid = _mm_cmpord_pd(x, x);
+        __m128d xs = _mm_or_pd(_mm_and_pd(valid, x), _mm_andnot_pd(valid, negInf));
+
+        // Running max within the register, then against the carried peak
+        __m128d peak = _mm_max_pd(xs, _mm_unpacklo_pd(negInf, xs));
+        peak = _mm_max_pd(peak, peakCarry);
+        peakCarry = _mm_unpackhi_pd(peak, peak);
+
+        __m128d dd = _mm_div_pd(_mm_sub_pd(x, peak), peak);
+        __m128d positive = _mm_cmpgt_pd(peak, zero);
+        dd = _mm_and_pd(dd, positive);  // no drawdown while peak <= 0
+        worst = _mm_min_pd(dd, worst);  // NaN dd keeps worst
+    }
+
+    double peak = _mm_cvtsd_f64(peakCarry);
+    double result = std::min(_mm_cvtsd_f64(worst), _mm_cvtsd_f64(_mm_unpackhi_pd(worst, worst)));
+    for (; i < n; ++i) {
+        double price = values[i];
+        if (price > peak) peak = price;
+        if (peak > 0.0) {
+            double drawdown = (price - peak) / peak;
+            if (drawdown < result) result = drawdown;
+        }
+    }
+    return result;
+}
+
+// ------------------- AVX2 (4 lanes) -------------------
+
+// Lane shifts toward higher indices, filling with `fill`
+__attribute__((target("avx2")))
+inline __m256d ShiftUp1(__m256d v, __m256d fill) {
+    return _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), fill, 0x1);
+}
+
+__attribute__((target("avx2")))
+inline __m256d ShiftUp2(__m256d v, __m256d fill) {
+    return _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(1, 0, 0, 0)), fill, 0x3);
+}
+
+__attribute__((target("avx2")))
+inline __m256d BroadcastLast(__m256d v) {
+    return _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+__attribute__((target("avx2")))
+void ReturnsAVX2(const double* close, size_t n, double* out) {
+    if (n == 0) return;
+    out[0] = kNaN;
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d nan = _mm256_set1_pd(kNaN);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cur = _mm256_loadu_pd(close + i);
+        __m256d prev = _mm256_loadu_pd(close + i - 1);
+        __m256d r = _mm256_div_pd(_mm256_sub_pd(cur, prev), prev);
+        __m256d isZero = _mm256_cmp_pd(prev, zero, _CMP_EQ_OQ);
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(r, nan, isZero));
+    }
+    for (; i < n; ++i) {
+        out[i] = (close[i - 1] == 0.0) ? kNaN : (close[i] - close[i - 1]) / close[i - 1];
+    }
+}
+
+__attribute__((target("avx2")))
+ColumnReduction ReduceAVX2(const double* values, size_t n) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d sum = _mm256_setzero_pd(), sumSq = _mm256_setzero_pd(), count = _mm256_setzero_pd();
+    __m256d mn = _mm256_set1_pd(kInf), mx = _mm256_set1_pd(-kInf);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d valid = _mm256_cmp_pd(x, x, _CMP_ORD_Q);
+        __m256d xv = _mm256_and_pd(x, valid);
+        sum = _mm256_add_pd(sum, xv);
+        sumSq = _mm256_add_pd(sumSq, _mm256_mul_pd(xv, xv));
+        count = _mm256_add_pd(count, _mm256_and_pd(valid, one));
+        mn = _mm256_min_pd(x, mn);
+        mx = _mm256_max_pd(x, mx);
+    }
+
+    alignas(32) double s[4], q[4], c[4], lo[4], hi[4];
+    _mm256_store_pd(s, sum);
+    _mm256_store_pd(q, sumSq);
+    _mm256_store_pd(c, count);
+    _mm256_store_pd(lo, mn);
+    _mm256_store_pd(hi, mx);
+
+    ColumnReduction tail = ReduceScalar(values + i, n - i);
+    ColumnReduction r;
+    r.sum = (s[0] + s[1]) + (s[2] + s[3]) + tail.sum;
+    r.sumSq = (q[0] + q[1]) + (q[2] + q[3]) + tail.sumSq;
+    r.min = std::min({ lo[0], lo[1], lo[2], lo[3], tail.min });
+    r.max = std::max({ hi[0], hi[1], hi[2], hi[3], tail.max });
+    r.count = static_cast<size_t>(c[0] + c[1] + c[2] + c[3]) + tail.count;
+    return r;
+}
+
+__attribute__((target("avx2")))
+void SlidingMeanAVX2(const double* values, size_t n, int window, double* out) {
+    if (window <= 0) {
+        std::fill(out, out + n, kNaN);
+        return;
+    }
+    const size_t w = static_cast<size_t>(window);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d invW = _mm256_set1_pd(1.0 / window);
+    __m256d carry = zero;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(values + i);
+        if (i >= w) {
+            v = _mm256_sub_pd(v, _mm256_loadu_pd(values + i - w));
+        } else if (i + 4 > w) {
+            alignas(32) double leaving[4];
+            LeavingValues<4>(values, i, w, leaving);
+            v = _mm256_sub_pd(v, _mm256_load_pd(leaving));
+        }
+        // Inclusive scan within the register, then add the running total
+        v = _mm256_add_pd(v, ShiftUp1(v, zero));
+        v = _mm256_add_pd(v, ShiftUp2(v, zero));
+        v = _mm256_add_pd(v, carry);
+        carry = BroadcastLast(v);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(v, invW));
+    }
+
+    double sum = _mm256_cvtsd_f64(carry);
+    for (; i < n; ++i) {
+        sum += values[i];
+        if (i >= w) sum -= values[i - w];
+        out[i] = sum / window;
+    }
+    std::fill(out, out + std::min(n, w - 1), kNaN);
+}
+
+__attribute__((target("avx2")))
+double MaxDrawdownAVX2(const double* values, size_t n) {
+    if (n == 0) return kNaN;
+    if (std::isnan(values[0])) return MaxDrawdownScalar(values, n);
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d negInf = _mm256_set1_pd(-kInf);
+    __m256d peakCarry = _mm256_set1_pd(values[0]);
+    __m256d worst = zero;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d valid = _mm256_cmp_pd(x, x, _CMP_ORD_Q);
+        __m256d xs = _mm256_blendv_pd(negInf, x, valid);
+
+        __m256d peak = _mm256_max_pd(xs, ShiftUp1(xs, negInf));
+        peak = _mm256_max_pd(peak, ShiftUp2(peak, negInf));
+        peak = _mm256_max_pd(peak, peakCarry);
+        peakCarry = BroadcastLast(peak);
+
+        __m256d dd = _mm256_div_pd(_mm256_sub_pd(x, peak), peak);
+        __m256d positive = _mm256_cmp_pd(peak, zero, _CMP_GT_OQ);
+        dd = _mm256_and_pd(dd, positive);
+        worst = _mm256_min_pd(dd, worst);
+    }
+
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, worst);
+    double result = std::min({ lanes[0], lanes[1], lanes[2], lanes[3] });
+    double peak = _mm256_cvtsd_f64(peakCarry);
+    for (; i < n; ++i) {
+        double price = values[i];
+        if (price > peak) peak = price;
+        if (peak > 0.0) {
+            double drawdown = (price - peak) / peak;
+            if (drawdown < result) result = drawdown;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+#endif // STOCKSENSE_X86
+
+// ------------------- Dispatch -------------------
+
+namespace {
+
+SimdLevel DetectSimdLevel() {
+#ifdef STOCKSENSE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const SimdLevel kSupportedLevel = DetectSimdLevel();
+std::atomic<SimdLevel> activeLevel{ kSupportedLevel };
+
+} // namespace
+
+SimdLevel ActiveSimdLevel() {
+    return activeLevel.load(std::memory_order_relaxed);
+}
+
+void SetSimdLevel(SimdLevel level) {
+    activeLevel.store(std::min(level, kSupportedLevel), std::memory_order_relaxed);
+}
+
+void ReturnsKernel(const double* close, size_t n, double* out) {
+    switch (ActiveSimdLevel()) {
+#ifdef STOCKSENSE_X86
+    case SimdLevel::AVX2: return ReturnsAVX2(close, n, out);
+    case SimdLevel::SSE2: return ReturnsSSE2(close, n, out);
+#endif
+    default: return ReturnsScalar(close, n, out);
+    }
+}
+
+ColumnReduction ReduceKernel(const double* values, size_t n) {
+    switch (ActiveSimdLevel()) {
+#ifdef STOCKSENSE_X86
+    case SimdLevel::AVX2: return ReduceAVX2(values, n);
+    case SimdLevel::SSE2: return ReduceSSE2(values, n);
+#endif
+    default: return ReduceScalar(values, n);
+    }
+}
+
+void SlidingMeanKernel(const double* values, size_t n, int window, double* out) {
+    switch (ActiveSimdLevel()) {
+#ifdef STOCKSENSE_X86
+    case SimdLevel::AVX2: return SlidingMeanAVX2(values, n, window, out);
+    case SimdLevel::SSE2: return SlidingMeanSSE2(values, n, window, out);
+#endif
+    default: return SlidingMeanScalar(values, n, window, out);
+    }
+}
+
+double MaxDrawdownKernel(const double* values, size_t n) {
+    switch (ActiveSimdLevel()) {
+#ifdef STOCKSENSE_X86
+    case SimdLevel::AVX2: return MaxDrawdownAVX2(values, n);
+    case SimdLevel::SSE2: return MaxDrawdownSSE2(values, n);
+#endif
+    default: return MaxDrawdownScalar(values, n);
+    }
+}
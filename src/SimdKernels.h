@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+// Vectorized primitives over contiguous double columns (e.g. PriceSeries::Close()).
+//
+// Each kernel has a scalar reference plus SSE2 and AVX2 versions. The widest
+// one the CPU supports is picked at runtime, so no special compiler flags are
+// needed. Results match the scalar reference up to floating-point
+// reassociation (sums are accumulated in a different order).
+
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Level the kernels currently dispatch to
+SimdLevel ActiveSimdLevel();
+
+// Override dispatch (clamped to what the CPU supports); meant for tests/benchmarks
+void SetSimdLevel(SimdLevel level);
+
+// Reduction over the non-NaN values of a column
+struct ColumnReduction {
+    double sum;
+    double sumSq;
+    double min;    // +inf when count == 0
+    double max;    // -inf when count == 0
+    size_t count;
+};
+
+// out[0] = NaN, out[i] = (close[i] - close[i-1]) / close[i-1], NaN where close[i-1] == 0
+void ReturnsKernel(const double* close, size_t n, double* out);
+
+ColumnReduction ReduceKernel(const double* values, size_t n);
+
+// out[i] = mean(values[i-window+1 .. i]) for i >= window - 1, NaN before
+// (and everywhere when window <= 0)
+void SlidingMeanKernel(const double* values, size_t n, int window, double* out);
+
+// Worst peak-to-trough drop as a fraction <= 0, running peak from values[0].
+// NaN values are skipped; returns NaN when n == 0.
+double MaxDrawdownKernel(const double* values, size_t n);
+
+// Scalar references, always available regardless of the active level
+void ReturnsScalar(const double* close, size_t n, double* out);
+ColumnReduction ReduceScalar(const double* values, size_t n);
+void SlidingMeanScalar(const double* values, size_t n, int window, double* out);
+double MaxDrawdownScalar(const double* values, size_t n);
@@ -1,95 +1,48 @@
 #include "StockAnalytics.h"
+#include "Fft.h"
+#include "OnlineIndicators.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
 #include <cmath>
 #include <limits>
 #include <algorithm>
+#include <complex>
 
 // ------------------- Basic analytics -------------------
 
-std::vector<double> StockAnalytics::SimpleMovingAverage(const std::vector<StockData>& data,
+std::vector<double> StockAnalytics::SimpleMovingAverage(const PriceSeries& data,
                                                         int window) {
-    std::vector<double> sma;
-    sma.reserve(data.size());
-
-    double sum = 0.0;
-
-    for (int i = 0; i < static_cast<int>(data.size()); ++i) {
-        sum += data[i].close;
-
-        if (i >= window) {
-            sum -= data[i - window].close;
-        }
-
-        if (i >= window - 1) {
-            sma.push_back(sum / window);
-        } else {
-            sma.push_back(std::numeric_limits<double>::quiet_NaN());
-        }
-    }
+    const PriceColumn close = data.Close();
+    std::vector<double> sma(close.size());
+    SlidingMeanKernel(close.data(), close.size(), window, sma.data());
     return sma;
 }
 
-std::vector<double> StockAnalytics::DailyReturns(const std::vector<StockData>& data) {
-    std::vector<double> ret;
-    ret.reserve(data.size());
-
-    if (data.empty()) {
-        return ret;
-    }
-
-    // First day has no prior day; mark as NaN
-    ret.push_back(std::numeric_limits<double>::quiet_NaN());
-
-    for (size_t i = 1; i < data.size(); ++i) {
-        if (data[i - 1].close == 0.0) {
-            ret.push_back(std::numeric_limits<double>::quiet_NaN());
-            continue;
-        }
-
-        double r = (data[i].close - data[i - 1].close) / data[i - 1].close;
-        ret.push_back(r);
-    }
+std::vector<double> StockAnalytics::DailyReturns(const PriceSeries& data) {
+    const PriceColumn close = data.Close();
+    // First day has no prior day and is marked NaN, as are days after a zero close
+    std::vector<double> ret(close.size());
+    ReturnsKernel(close.data(), close.size(), ret.data());
     return ret;
 }
 
-std::vector<double> StockAnalytics::RollingVolatility(const std::vector<StockData>& data,
+std::vector<double> StockAnalytics::RollingVolatility(const PriceSeries& data,
                                                       int window) {
-    auto ret = DailyReturns(data);
-    std::vector<double> vol;
-    vol.reserve(ret.size());
+    return RollingVolatility(DailyReturns(data), window);
+}
 
-    for (int i = 0; i < static_cast<int>(ret.size()); ++i) {
-        if (i < window) {
-            vol.push_back(std::numeric_limits<double>::quiet_NaN());
-            continue;
-        }
+std::vector<double> StockAnalytics::RollingVolatility(const std::vector<double>& returns,
+                                                      int window) {
+    std::vector<double> vol(returns.size(), std::numeric_limits<double>::quiet_NaN());
+    if (window <= 0) {
+        return vol;
+    }
 
-        double mean = 0.0;
-        int count = 0;
-        for (int j = i - window + 1; j <= i; ++j) {
-            if (std::isnan(ret[j])) continue;
-            mean += ret[j];
-            ++count;
-        }
-        if (count == 0) {
-            vol.push_back(std::numeric_limits<double>::quiet_NaN());
-            continue;
-        }
-        mean /= count;
-
-        double variance = 0.0;
-        int count2 = 0;
-        for (int j = i - window + 1; j <= i; ++j) {
-            if (std::isnan(ret[j])) continue;
-            double diff = ret[j] - mean;
-            variance += diff * diff;
-            ++count2;
-        }
-        if (count2 <= 1) {
-            vol.push_back(std::numeric_limits<double>::quiet_NaN());
-        } else {
-            variance /= (count2 - 1);  // sample variance
-            vol.push_back(std::sqrt(variance));
-        }
+    // Slide the window one return at a time (see OnlineVolatility), so the
+    // whole pass is O(n) regardless of the window length
+    OnlineVolatility online(window);
+    for (size_t i = 0; i < returns.size(); ++i) {
+        vol[i] = online.Update(returns[i]);
     }
     return vol;
 }
@@ -103,18 +56,12 @@ ReturnStats StockAnalytics::ComputeReturnStats(const std::vector<double>& return
     stats.min = std::numeric_limits<double>::infinity();
     stats.max = -std::numeric_limits<double>::infinity();
 
-    double sum = 0.0;
-    double sumSq = 0.0;
-    int count = 0;
-
-    for (double r : returns) {
-        if (std::isnan(r)) continue;
-        sum += r;
-        sumSq += r * r;
-        stats.min = std::min(stats.min, r);
-        stats.max = std::max(stats.max, r);
-        ++count;
-    }
+    const ColumnReduction r = ReduceKernel(returns.data(), returns.size());
+    const double sum = r.sum;
+    const double sumSq = r.sumSq;
+    const size_t count = r.count;
+    stats.min = r.min;
+    stats.max = r.max;
 
     if (count == 0) {
         stats.mean = stats.stddev = stats.min = stats.max =
@@ -144,13 +91,13 @@ double StockAnalytics::SharpeRatio(const std::vector<double>& returns, double ri
     return excessMean / stats.stddev;
 }
 
-double StockAnalytics::YearToDatePerformance(const std::vector<StockData>& data) {
+double StockAnalytics::YearToDatePerformance(const PriceSeries& data) {
     if (data.size() < 2) {
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    double firstClose = data.front().close;
-    double lastClose  = data.back().close;
+    double firstClose = data.Close().front();
+    double lastClose  = data.Close().back();
 
     if (firstClose == 0.0) {
         return std::numeric_limits<double>::quiet_NaN();
@@ -159,38 +106,20 @@ double StockAnalytics::YearToDatePerformance(const std::vector<StockData>& data)
     return (lastClose - firstClose) / firstClose;
 }
 
-double StockAnalytics::MaxDrawdown(const std::vector<StockData>& data) {
-    if (data.empty()) {
-        return std::numeric_limits<double>::quiet_NaN();
-    }
-
-    double maxPeak = data.front().close;
-    double maxDrawdown = 0.0; // we’ll keep this as a negative number
-
-    for (size_t i = 1; i < data.size(); ++i) {
-        double price = data[i].close;
-        if (price > maxPeak) {
-            maxPeak = price;
-        }
-
-        if (maxPeak > 0.0) {
-            double drawdown = (price - maxPeak) / maxPeak; // will be <= 0
-            if (drawdown < maxDrawdown) {
-                maxDrawdown = drawdown;
-            }
-        }
-    }
-
-    return maxDrawdown; // e.g. -0.25 means -25% from peak
+double StockAnalytics::MaxDrawdown(const PriceSeries& data) {
+    // Worst drop from the running peak, kept as a negative number
+    const PriceColumn close = data.Close();
+    return MaxDrawdownKernel(close.data(), close.size());
 }
 
-void StockAnalytics::BollingerBands(const std::vector<StockData>& data,
+void StockAnalytics::BollingerBands(const PriceSeries& data,
                                     int window,
                                     std::vector<double>& middle,
                                     std::vector<double>& upper,
                                     std::vector<double>& lower,
                                     double numStdDev) {
-    const size_t n = data.size();
+    const PriceColumn close = data.Close();
+    const size_t n = close.size();
     middle.assign(n, std::numeric_limits<double>::quiet_NaN());
     upper.assign(n,  std::numeric_limits<double>::quiet_NaN());
     lower.assign(n,  std::numeric_limits<double>::quiet_NaN());
@@ -200,31 +129,12 @@ void StockAnalytics::BollingerBands(const std::vector<StockData>& data,
     }
 
     // Rolling mean and std on closing prices
-    double sum = 0.0;
-    double sumSq = 0.0;
-
-    for (int i = 0; i < static_cast<int>(n); ++i) {
-        double price = data[i].close;
-        sum += price;
-        sumSq += price * price;
-
-        if (i >= window) {
-            double oldPrice = data[i - window].close;
-            sum   -= oldPrice;
-            sumSq -= oldPrice * oldPrice;
-        }
-
-        if (i >= window - 1) {
-            int count = window;
-            double mean = sum / count;
-            double variance = (sumSq / count) - (mean * mean);
-            if (variance < 0.0) variance = 0.0;
-            double stddev = std::sqrt(variance);
-
-            middle[i] = mean;
-            upper[i]  = mean + numStdDev * stddev;
-            lower[i]  = mean - numStdDev * stddev;
-        }
+    OnlineBollinger bands(window, numStdDev);
+    for (size_t i = 0; i < n; ++i) {
+        bands.Update(close[i]);
+        middle[i] = bands.middle();
+        upper[i]  = bands.upper();
+        lower[i]  = bands.lower();
     }
 }
 
@@ -285,19 +195,199 @@ double StockAnalytics::Autocorrelation(const std::vector<double>& values, int la
 }
 
 std::vector<double> StockAnalytics::AutocorrelationFunction(const std::vector<double>& values, int maxLag) {
-    std::vector<double> acf;
-    acf.reserve(maxLag);
+    if (maxLag <= 0) {
+        return {};
+    }
+    return AutocorrelationSpectrum(values, maxLag).acf;
+}
+
+namespace {
+
+// Regularized upper incomplete gamma Q(a, x) (Numerical Recipes: series below
+// a + 1, Lentz continued fraction above)
+double UpperIncompleteGamma(double a, double x) {
+    if (x <= 0.0) return 1.0;
+    const double logPrefix = -x + a * std::log(x) - std::lgamma(a);
+
+    if (x < a + 1.0) {
+        double term = 1.0 / a;
+        double sum = term;
+        for (int n = 1; n < 500; ++n) {
+            term *= x / (a + n);
+            sum += term;
+            if (std::fabs(term) < std::fabs(sum) * 1e-15) break;
+        }
+        return 1.0 - sum * std::exp(logPrefix);
+    }
+
+    const double tiny = 1e-300;
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < 500; ++i) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = b + an / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < 1e-15) break;
+    }
+    return std::exp(logPrefix) * h;
+}
+
+// Cross-correlation r[k] = sum_t a[t] * b[t-k] for k = 0..maxLag, from spectra
+// (inverse of A * conj(B)). Both products have real results, so they share
+// one inverse transform: real part -> first, imaginary part -> second.
+void InverseCorrelationPair(const std::vector<std::complex<double>>& A1,
+                            const std::vector<std::complex<double>>& B1,
+                            const std::vector<std::complex<double>>& A2,
+                            const std::vector<std::complex<double>>& B2,
+                            int maxLag,
+                            std::vector<double>& first,
+                            std::vector<double>& second) {
+    const size_t fftSize = A1.size();
+    std::vector<std::complex<double>> spectrum(fftSize);
+    const std::complex<double> i(0.0, 1.0);
+    for (size_t f = 0; f < fftSize; ++f) {
+        spectrum[f] = A1[f] * std::conj(B1[f]) + i * (A2[f] * std::conj(B2[f]));
+    }
+    Fft(spectrum, true);
+
+    first.resize(maxLag + 1);
+    second.resize(maxLag + 1);
+    for (int k = 0; k <= maxLag; ++k) {
+        first[k] = spectrum[k].real();
+        second[k] = spectrum[k].imag();
+    }
+}
+
+// Single cross-correlation, for when there is nothing to pair it with
+void InverseCorrelation(const std::vector<std::complex<double>>& A,
+                        const std::vector<std::complex<double>>& B,
+                        int maxLag,
+                        std::vector<double>& out) {
+    std::vector<std::complex<double>> spectrum(A.size());
+    for (size_t f = 0; f < A.size(); ++f) {
+        spectrum[f] = A[f] * std::conj(B[f]);
+    }
+    Fft(spectrum, true);
+
+    out.resize(maxLag + 1);
+    for (int k = 0; k <= maxLag; ++k) {
+        out[k] = spectrum[k].real();
+    }
+}
+
+} // namespace
+
+AcfResult StockAnalytics::AutocorrelationSpectrum(const std::vector<double>& values, int maxLag,
+                                                  AcfMethod method) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    AcfResult result;
+    result.acf.assign(std::max(maxLag, 0), nan);
+    result.validCount = 0;
+    result.ljungBoxLags = 0;
+    result.ljungBoxQ = result.boxPierceQ = result.ljungBoxPValue = nan;
+
+    const size_t n = values.size();
+    if (maxLag <= 0 || n == 0) {
+        return result;
+    }
+
+    // Mean over valid values, computed once for every lag
+    double sum = 0.0;
+    int count = 0;
+    for (double v : values) {
+        if (!std::isnan(v)) {
+            sum += v;
+            ++count;
+        }
+    }
+    result.validCount = count;
+    if (count == 0) {
+        return result;
+    }
+    const double mean = sum / count;
+
+    // Centred values with NaN masked to zero, plus the validity mask
+    std::vector<double> centred(n), centredSq(n), mask(n);
+    for (size_t t = 0; t < n; ++t) {
+        bool valid = !std::isnan(values[t]);
+        double c = valid ? values[t] - mean : 0.0;
+        centred[t] = c;
+        centredSq[t] = c * c;
+        mask[t] = valid ? 1.0 : 0.0;
+    }
 
-    for (int lag = 1; lag <= maxLag; ++lag) {
-        acf.push_back(Autocorrelation(values, lag));
+    // Lags that reach past the data stay NaN, like Autocorrelation()
+    const int lagLimit = static_cast<int>(std::min<size_t>(maxLag, n - 1));
+
+    // Per lag k:
+    //   autocov[k]  = sum_t centred[t] * centred[t-k]
+    //   variance[k] = sum_t centred[t]^2 * mask[t-k]   (lagged value must be valid)
+    //   pairs[k]    = sum_t mask[t] * mask[t-k]
+    std::vector<double> autocov, variance, pairs;
+
+    const size_t fftSize = NextPowerOfTwo(n + lagLimit);
+    const double directCost = static_cast<double>(n) * lagLimit;
+    const double fftCost = 8.0 * fftSize * std::log2(static_cast<double>(fftSize));
+    bool useFft = method == AcfMethod::Fft || (method == AcfMethod::Auto && directCost > fftCost);
+
+    if (useFft) {
+        std::vector<std::complex<double>> C, M, S, unused;
+        FftTwoReal(centred.data(), mask.data(), n, fftSize, C, M);
+        FftTwoReal(centredSq.data(), nullptr, n, fftSize, S, unused);
+        InverseCorrelationPair(C, C, M, M, lagLimit, autocov, pairs);
+        InverseCorrelation(S, M, lagLimit, variance);
+        for (double& p : pairs) p = std::round(p);  // counts are integers; drop FFT noise
+    } else {
+        autocov.assign(lagLimit + 1, 0.0);
+        variance.assign(lagLimit + 1, 0.0);
+        pairs.assign(lagLimit + 1, 0.0);
+        for (int k = 1; k <= lagLimit; ++k) {
+            double cov = 0.0, var = 0.0, cnt = 0.0;
+            for (size_t t = k; t < n; ++t) {
+                cov += centred[t] * centred[t - k];
+                var += centredSq[t] * mask[t - k];
+                cnt += mask[t] * mask[t - k];
+            }
+            autocov[k] = cov;
+            variance[k] = var;
+            pairs[k] = cnt;
+        }
     }
 
-    return acf;
+    double sumLjung = 0.0, sumSquares = 0.0;
+    for (int k = 1; k <= lagLimit; ++k) {
+        if (pairs[k] < 0.5 || variance[k] <= 0.0) continue;
+        double r = autocov[k] / variance[k];
+        result.acf[k - 1] = r;
+        if (k < count) {
+            sumLjung += r * r / (count - k);
+            ++result.ljungBoxLags;
+        }
+        sumSquares += r * r;
+    }
+
+    const double nValid = static_cast<double>(count);
+    result.ljungBoxQ = nValid * (nValid + 2.0) * sumLjung;
+    result.boxPierceQ = nValid * sumSquares;
+    // The statistic has one degree of freedom per lag it actually sums, not
+    // per lag requested: lags past the data or without valid pairs add none
+    if (result.ljungBoxLags > 0) {
+        result.ljungBoxPValue = UpperIncompleteGamma(0.5 * result.ljungBoxLags, 0.5 * result.ljungBoxQ);
+    }
+    return result;
 }
 
 // ------------------- Hurst Exponent -------------------
 
-double StockAnalytics::HurstExponent(const std::vector<double>& values) {
+double StockAnalytics::HurstExponent(const std::vector<double>& values, HurstMode mode) {
     // Need sufficient data for meaningful analysis
     if (values.size() < 20) {
         return std::numeric_limits<double>::quiet_NaN();
@@ -318,7 +408,6 @@ double StockAnalytics::HurstExponent(const std::vector<double>& values) {
     // Use Rescaled Range (R/S) analysis
     // Test multiple window sizes and compute R/S for each
     std::vector<int> windowSizes;
-    std::vector<double> rescaledRanges;
 
     // Generate window sizes (powers and mid-points)
     int minWindow = 10;
@@ -333,70 +422,69 @@ double StockAnalytics::HurstExponent(const std::vector<double>& values) {
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    // For each window size, compute average R/S
-    for (int window : windowSizes) {
-        std::vector<double> rsValues;
+    // Prefix sums of the values and their squares give every segment's mean and
+    // variance in O(1), so no segment is ever copied. Values are centred on the
+    // global mean first to keep the sum-of-squares variance well conditioned.
+    const size_t n = cleanValues.size();
+    double globalMean = 0.0;
+    for (double v : cleanValues) globalMean += v;
+    globalMean /= n;
+
+    std::vector<double> prefix(n + 1, 0.0);
+    std::vector<double> prefixSq(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        double v = cleanValues[i] - globalMean;
+        prefix[i + 1] = prefix[i] + v;
+        prefixSq[i + 1] = prefixSq[i] + v * v;
+    }
 
-        // Slide window through the data
-        for (size_t start = 0; start + window <= cleanValues.size(); ++start) {
-            // Extract window
-            std::vector<double> segment(cleanValues.begin() + start, 
-                                       cleanValues.begin() + start + window);
+    // Average R/S for each window size (NaN when no segment had any spread).
+    // Window sizes are independent, so they run in parallel.
+    std::vector<double> rescaledRanges(windowSizes.size(), std::numeric_limits<double>::quiet_NaN());
 
-            // Calculate mean
-            double mean = 0.0;
-            for (double v : segment) mean += v;
-            mean /= segment.size();
+    ParallelFor(windowSizes.size(), [&](size_t w) {
+        const int window = windowSizes[w];
+        const size_t step = (mode == HurstMode::Overlapping) ? 1 : static_cast<size_t>(window);
 
-            // Calculate cumulative deviations from mean
-            std::vector<double> cumDev(window);
-            cumDev[0] = segment[0] - mean;
-            for (int i = 1; i < window; ++i) {
-                cumDev[i] = cumDev[i-1] + (segment[i] - mean);
-            }
+        double sumRS = 0.0;
+        size_t countRS = 0;
 
-            // Calculate range R
-            double maxCumDev = cumDev[0];
-            double minCumDev = cumDev[0];
-            for (double cd : cumDev) {
-                if (cd > maxCumDev) maxCumDev = cd;
-                if (cd < minCumDev) minCumDev = cd;
-            }
-            double range = maxCumDev - minCumDev;
+        for (size_t start = 0; start + window <= n; start += step) {
+            const double base = prefix[start];
+            const double mean = (prefix[start + window] - base) / window;
 
-            // Calculate standard deviation S
-            double variance = 0.0;
-            for (double v : segment) {
-                double diff = v - mean;
-                variance += diff * diff;
-            }
-            variance /= segment.size();
+            // Standard deviation S (population, as in classic R/S)
+            double variance = (prefixSq[start + window] - prefixSq[start]) / window - mean * mean;
+            if (variance < 0.0) variance = 0.0;
             double stddev = std::sqrt(variance);
 
             // Avoid division by zero
-            if (stddev > 1e-10) {
-                rsValues.push_back(range / stddev);
+            if (stddev <= 1e-10) continue;
+
+            // Range R of the cumulative deviations from the segment mean:
+            // cumDev[k] = (prefix[start+k+1] - prefix[start]) - (k+1) * mean
+            double maxCumDev = -std::numeric_limits<double>::infinity();
+            double minCumDev = std::numeric_limits<double>::infinity();
+            for (int k = 1; k <= window; ++k) {
+                double cd = (prefix[start + k] - base) - k * mean;
+                maxCumDev = std::max(maxCumDev, cd);
+                minCumDev = std::min(minCumDev, cd);
             }
-        }
 
-        // Average R/S for this window size
-        if (!rsValues.empty()) {
-            double avgRS = 0.0;
-            for (double rs : rsValues) avgRS += rs;
-            avgRS /= rsValues.size();
-            rescaledRanges.push_back(avgRS);
+            sumRS += (maxCumDev - minCumDev) / stddev;
+            ++countRS;
         }
-    }
 
-    if (rescaledRanges.size() < 3) {
-        return std::numeric_limits<double>::quiet_NaN();
-    }
+        if (countRS > 0) {
+            rescaledRanges[w] = sumRS / countRS;
+        }
+    });
 
     // Fit log(R/S) = H * log(n) + constant
     // Hurst exponent H is the slope
     std::vector<double> logN, logRS;
-    for (size_t i = 0; i < windowSizes.size() && i < rescaledRanges.size(); ++i) {
-        if (rescaledRanges[i] > 0) {
+    for (size_t i = 0; i < windowSizes.size(); ++i) {
+        if (rescaledRanges[i] > 0) {  // false for NaN too
             logN.push_back(std::log(windowSizes[i]));
             logRS.push_back(std::log(rescaledRanges[i]));
         }
@@ -1,6 +1,6 @@
 #pragma once
 #include <vector>
-#include "StockData.h"
+#include "PriceSeries.h"
 
 // Summary statistics for daily returns
 struct ReturnStats {
@@ -10,12 +10,40 @@ struct ReturnStats {
     double max;      // best daily return
 };
 
+// Full autocorrelation spectrum plus portmanteau statistics from one pass
+struct AcfResult {
+    std::vector<double> acf;  // lag 1..maxLag (NaN where a lag has no valid pairs)
+    int validCount;           // number of non-NaN observations
+    double ljungBoxQ;         // Q = n(n+2) * sum(acf_k^2 / (n-k))
+    double boxPierceQ;        // Q = n * sum(acf_k^2)
+    int ljungBoxLags;         // lags summed into ljungBoxQ (fewer than maxLag on short series)
+    double ljungBoxPValue;    // P(chi2 with ljungBoxLags dof > ljungBoxQ); small = serial correlation
+};
+
+// How AutocorrelationSpectrum evaluates the lags
+enum class AcfMethod {
+    Auto,    // direct for short series / few lags, FFT otherwise
+    Direct,  // O(n * maxLag)
+    Fft      // O(n log n), independent of maxLag
+};
+
+// How HurstExponent cuts the series into segments of each window size
+enum class HurstMode {
+    Overlapping,     // every start position (smoother estimate, O(n * window))
+    NonOverlapping   // classic R/S: consecutive disjoint blocks (O(n) per window)
+};
+
 class StockAnalytics {
 public:
     // ---- Existing basic analytics ----
-    std::vector<double> SimpleMovingAverage(const std::vector<StockData>& data, int window);
-    std::vector<double> DailyReturns(const std::vector<StockData>& data);
-    std::vector<double> RollingVolatility(const std::vector<StockData>& data, int window);
+    std::vector<double> SimpleMovingAverage(const PriceSeries& data, int window);
+    std::vector<double> DailyReturns(const PriceSeries& data);
+    std::vector<double> RollingVolatility(const PriceSeries& data, int window);
+
+    // Rolling sample standard deviation of precomputed returns over the last
+    // `window` values, in O(n). NaN returns are skipped; entries before index
+    // `window` (or with fewer than two valid returns) are NaN.
+    std::vector<double> RollingVolatility(const std::vector<double>& returns, int window);
 
     // ---- New extras ----
 
@@ -28,18 +56,18 @@ public:
 
     // Year-to-date performance (or full period performance if you give all data):
     // (last_close - first_close) / first_close
-    double YearToDatePerformance(const std::vector<StockData>& data);
+    double YearToDatePerformance(const PriceSeries& data);
 
     // Maximum drawdown (worst peak-to-trough drop) over the period.
     // Returned as a negative fraction, e.g. -0.20 for -20%.
-    double MaxDrawdown(const std::vector<StockData>& data);
+    double MaxDrawdown(const PriceSeries& data);
 
     // Bollinger Bands:
     // middle = SMA(window)
     // upper  = SMA + numStdDev * rolling_std
     // lower  = SMA - numStdDev * rolling_std
     // For indices < window-1, values are set to NAN.
-    void BollingerBands(const std::vector<StockData>& data,
+    void BollingerBands(const PriceSeries& data,
                         int window,
                         std::vector<double>& middle,
                         std::vector<double>& upper,
@@ -59,6 +87,13 @@ public:
     // Useful for detecting patterns at different time scales (momentum, mean reversion)
     std::vector<double> AutocorrelationFunction(const std::vector<double>& values, int maxLag);
 
+    // Same values as AutocorrelationFunction, computed for all lags at once.
+    // NaN entries are masked out, so each lag only uses pairs where both values
+    // are valid (exactly as Autocorrelation does). Also returns Ljung-Box and
+    // Box-Pierce statistics for lags 1..maxLag.
+    AcfResult AutocorrelationSpectrum(const std::vector<double>& values, int maxLag,
+                                      AcfMethod method = AcfMethod::Auto);
+
     // ---- Hurst Exponent ----
 
     // Compute Hurst Exponent using Rescaled Range (R/S) analysis
@@ -66,5 +101,7 @@ public:
     // H = 0.5: Random walk (geometric Brownian motion)
     // H < 0.5: Mean-reverting behavior (anti-persistent)
     // Returns NaN if insufficient data
-    double HurstExponent(const std::vector<double>& values);
+    // Window sizes are evaluated in parallel on the shared thread pool.
+    double HurstExponent(const std::vector<double>& values,
+                         HurstMode mode = HurstMode::Overlapping);
 };
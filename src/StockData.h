@@ -1,8 +1,8 @@
 #pragma once
-#include <string>
+#include <cstdint>
 
 struct StockData {
-    std::string date;
+    int32_t date;  // days since 1970-01-01, see TradingDate.h
     double open;
     double high;
     double low;
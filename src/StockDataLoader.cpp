@@ -1,10 +1,14 @@
 #include "StockDataLoader.h"
-#include "rapidcsv.h"
+#include "MappedFile.h"
+#include "PriceCsvParser.h"
+#include "SeriesCache.h"
+#include "ThreadPool.h"
 #include <curl/curl.h>
-#include <sstream>
 #include <iostream>
 #include <fstream>
 #include <ctime>
+#include <mutex>
+#include <set>
 
 static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
     size_t totalSize = size * nmemb;
@@ -12,62 +16,33 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::stri
     return totalSize;
 }
 
-std::vector<StockData> StockDataLoader::LoadFromCSV(const std::string& filepath) {
-    std::vector<StockData> data;
-    try {
-        rapidcsv::Document doc(filepath, rapidcsv::LabelParams(0, -1));
-
-        // Try standard Yahoo Finance format first
-        std::vector<std::string> dates;
-        std::vector<double> opens, highs, lows, closes, volumes;
-        
-        try {
-            dates = doc.GetColumn<std::string>("Date");
-            opens = doc.GetColumn<double>("Open");
-            highs = doc.GetColumn<double>("High");
-            lows = doc.GetColumn<double>("Low");
-            closes = doc.GetColumn<double>("Close");
-            volumes = doc.GetColumn<double>("Volume");
-        } catch (...) {
-            // If that fails, the file might have different format - try to detect
-            std::cerr << "Standard format failed, attempting auto-detection...\n";
-            
-            // Check if columns exist with different names/order
-            std::vector<std::string> colNames = doc.GetColumnNames();
-            
-            for (const auto& col : colNames) {
-                std::cout << "Found column: " << col << "\n";
-            }
-            
-            // Handle formats with underscores (Adj_Close, etc.)
-            dates = doc.GetColumn<std::string>("Date");
-            opens = doc.GetColumn<double>("Open");
-            highs = doc.GetColumn<double>("High");
-            lows = doc.GetColumn<double>("Low");
-            closes = doc.GetColumn<double>("Close");
-            volumes = doc.GetColumn<double>("Volume");
-        }
+// Parse the CSV at filepath. With source, also identifies the exact bytes
+// that were parsed, for SeriesCache::Store.
+static PriceSeries ReadPriceCSV(const std::string& filepath, std::string& error,
+                                SeriesCache::SourceIdentity* source = nullptr) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        error = "cannot open " + filepath;
+        return PriceSeries();
+    }
+    if (source) *source = SeriesCache::Identify(file);
+    return PriceCsvParser::Parse(file.view(), error);
+}
 
-        // Clean date format if it has timezone info (e.g., "2010-01-04 00:00:00+00:00")
-        for (size_t i = 0; i < dates.size(); ++i) {
-            std::string cleanDate = dates[i];
-            
-            // Extract just the date part (YYYY-MM-DD) if there's a space
-            size_t spacePos = cleanDate.find(' ');
-            if (spacePos != std::string::npos) {
-                cleanDate = cleanDate.substr(0, spacePos);
-            }
-            
-            data.push_back({ cleanDate, opens[i], highs[i], lows[i], closes[i], volumes[i] });
-        }
-    } 
-    catch (const std::exception& e) {
-        std::cerr << "Error loading CSV: " << e.what() << std::endl;
+PriceSeries StockDataLoader::LoadFromCSV(const std::string& filepath) {
+    std::string error;
+    PriceSeries data = ReadPriceCSV(filepath, error);
+    if (!error.empty()) {
+        std::cerr << "Error loading CSV: " << error << std::endl;
     }
     return data;
 }
 
-std::string StockDataLoader::FetchFromURL(const std::string& url) {
+std::string StockDataLoader::FetchFromURL(const std::string& url, std::string& error) {
+    // curl_global_init is not thread-safe; run it once before any handle exists
+    static std::once_flag curlInit;
+    std::call_once(curlInit, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
     CURL* curl = curl_easy_init();
     std::string readBuffer;
 
@@ -81,67 +56,48 @@ std::string StockDataLoader::FetchFromURL(const std::string& url) {
         
         CURLcode res = curl_easy_perform(curl);
         if (res != CURLE_OK) {
-            std::cerr << "CURL Error: " << curl_easy_strerror(res) << "\n";
-            std::cerr << "URL attempted: " << url << "\n";
+            error = std::string("CURL Error: ") + curl_easy_strerror(res);
         }
         curl_easy_cleanup(curl);
     }
     return readBuffer;
 }
 
-std::vector<StockData> StockDataLoader::LoadFromAPI(
-    const std::string& ticker, const std::string& startDate, const std::string& endDate) {
+PriceSeries StockDataLoader::DownloadTicker(
+    const std::string& ticker, std::string& url, std::string& error) {
 
     // Use dynamic timestamps for the past year
     std::time_t now = std::time(nullptr);
     std::time_t yearAgo = now - (365 * 24 * 60 * 60);
     
     // Try Yahoo Finance with updated endpoint
-    std::string url = "https://query1.finance.yahoo.com/v7/finance/download/" + ticker +
+    url = "https://query1.finance.yahoo.com/v7/finance/download/" + ticker +
                       "?period1=" + std::to_string(yearAgo) + 
                       "&period2=" + std::to_string(now) +
                       "&interval=1d&events=history&includeAdjustedClose=true";
     
-    std::cout << "Fetching from: " << url << "\n";
-    std::string csvContent = FetchFromURL(url);
+    std::string csvContent = FetchFromURL(url, error);
     
     if (csvContent.empty() || csvContent.find("Date") == std::string::npos) {
-        std::cerr << "Failed to fetch data from Yahoo Finance.\n";
-        std::cerr << "Please download " << ticker << ".csv manually or use local file.\n";
+        if (error.empty()) error = "no CSV data in response";
         return {};
     }
     
-    return ParseCSV(csvContent);
+    return PriceCsvParser::Parse(csvContent, error);
 }
 
-std::vector<StockData> StockDataLoader::ParseCSV(const std::string& csvContent) {
-    std::vector<StockData> data;
-    std::stringstream ss(csvContent);
-    std::string line;
-    bool firstLine = true;
-
-    while (std::getline(ss, line)) {
-        if (firstLine) { firstLine = false; continue; }  // skip header
-
-        std::stringstream lineStream(line);
-        std::string cell;
-        std::vector<std::string> tokens;
+PriceSeries StockDataLoader::LoadFromAPI(
+    const std::string& ticker, const std::string& startDate, const std::string& endDate) {
 
-        while (std::getline(lineStream, cell, ',')) tokens.push_back(cell);
-        if (tokens.size() < 6) continue;
+    std::string url, error;
+    PriceSeries data = DownloadTicker(ticker, url, error);
+    std::cout << "Fetching from: " << url << "\n";
 
-        try {
-            data.push_back({
-                tokens[0],
-                std::stod(tokens[1]),
-                std::stod(tokens[2]),
-                std::stod(tokens[3]),
-                std::stod(tokens[4]),
-                std::stod(tokens[6])
-            });
-        } catch (...) {
-            continue; // skip bad rows
-        }
+    if (data.empty()) {
+        if (!error.empty()) std::cerr << error << "\n";
+        std::cerr << "URL attempted: " << url << "\n";
+        std::cerr << "Failed to fetch data from Yahoo Finance.\n";
+        std::cerr << "Please download " << ticker << ".csv manually or use local file.\n";
     }
     return data;
 }
@@ -166,28 +122,110 @@ std::string StockDataLoader::FindTickerCSV(const std::string& ticker) {
     return "";  // Not found
 }
 
-std::vector<StockData> StockDataLoader::LoadByTicker(const std::string& ticker) {
-    std::cout << "Loading data for ticker: " << ticker << "\n";
-    
+TickerLoadResult StockDataLoader::LoadTicker(const std::string& ticker, bool allowFetch) {
+    TickerLoadResult result;
+
     // First, try to find local CSV file
     std::string csvPath = FindTickerCSV(ticker);
-    
+
     if (!csvPath.empty()) {
-        std::cout << "Found local CSV: " << csvPath << "\n";
-        return LoadFromCSV(csvPath);
+        result.source = csvPath;
+
+        // Reuse the binary sidecar from an earlier run when the CSV is unchanged
+        if (SeriesCache::Load(csvPath, result.series)) {
+            result.fromCache = true;
+            result.status = LoadStatus::Ok;
+            return result;
+        }
+
+        SeriesCache::SourceIdentity source;
+        result.series = ReadPriceCSV(csvPath, result.error, &source);
+        if (result.series.empty()) {
+            if (result.error.empty()) result.error = "no data rows in " + csvPath;
+            result.status = LoadStatus::ParseError;
+            return result;
+        }
+
+        SeriesCache::Store(csvPath, source, result.series);
+        result.status = LoadStatus::Ok;
+        return result;
     }
-    
+
+    if (!allowFetch) {
+        result.status = LoadStatus::NotFound;
+        result.error = "no local CSV for " + ticker;
+        return result;
+    }
+
     // If not found locally, fetch from API
+    result.fromAPI = true;
+    result.series = DownloadTicker(ticker, result.source, result.error);
+    if (result.series.empty()) {
+        if (result.error.empty()) result.error = "no data retrieved for " + ticker;
+        result.status = LoadStatus::FetchFailed;
+        return result;
+    }
+
+    result.status = LoadStatus::Ok;
+    return result;
+}
+
+PriceSeries StockDataLoader::LoadByTicker(const std::string& ticker) {
+    std::cout << "Loading data for ticker: " << ticker << "\n";
+
+    TickerLoadResult result = LoadTicker(ticker, true);
+
+    if (!result.fromAPI) {
+        std::cout << "Found local CSV: " << result.source << "\n";
+        if (result.fromCache) {
+            std::cout << "Using cached series: " << SeriesCache::SidecarPath(result.source) << "\n";
+        }
+        if (result.status != LoadStatus::Ok) {
+            std::cerr << "Error loading CSV: " << result.error << std::endl;
+        }
+        return result.series;
+    }
+
     std::cout << "CSV not found locally, fetching from Yahoo Finance...\n";
-    
-    // Get current date and 1 year ago for default range
-    auto data = LoadFromAPI(ticker, "2024-01-01", "2025-12-31");
-    
-    if (!data.empty()) {
-        std::cout << "Successfully fetched " << data.size() << " data points from API\n";
+    std::cout << "Fetching from: " << result.source << "\n";
+
+    if (result.status == LoadStatus::Ok) {
+        std::cout << "Successfully fetched " << result.series.size() << " data points from API\n";
     } else {
+        std::cerr << result.error << "\n";
         std::cout << "Warning: No data retrieved for ticker " << ticker << "\n";
     }
-    
-    return data;
+
+    return result.series;
+}
+
+std::map<std::string, TickerLoadResult> StockDataLoader::LoadByTickers(
+    const std::vector<std::string>& tickers, bool allowFetch, size_t maxWorkers) {
+
+    std::set<std::string> unique(tickers.begin(), tickers.end());
+    std::map<std::string, TickerLoadResult> results;
+    if (unique.empty()) return results;
+
+    size_t workers = maxWorkers ? maxWorkers : ThreadPool::DefaultThreadCount();
+    ThreadPool pool(std::min(workers, unique.size()));
+
+    std::vector<std::pair<std::string, std::future<TickerLoadResult>>> pending;
+    pending.reserve(unique.size());
+    for (const auto& ticker : unique) {
+        pending.emplace_back(ticker, pool.Submit([this, ticker, allowFetch] {
+            return LoadTicker(ticker, allowFetch);
+        }));
+    }
+
+    for (auto& [ticker, future] : pending) {
+        try {
+            results.emplace(ticker, future.get());
+        } catch (const std::exception& e) {
+            TickerLoadResult failed;
+            failed.status = LoadStatus::ParseError;
+            failed.error = e.what();
+            results.emplace(ticker, std::move(failed));
+        }
+    }
+    return results;
 }
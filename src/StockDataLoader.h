@@ -1,22 +1,53 @@
 #pragma once
+#include <map>
 #include <string>
 #include <vector>
-#include "StockData.h"
+#include "PriceSeries.h"
+
+// Outcome of loading one ticker without console output
+enum class LoadStatus {
+    Ok,
+    NotFound,     // no local CSV and API fetching was not allowed
+    ParseError,   // a CSV was found but yielded no usable rows
+    FetchFailed   // the API download failed or returned no rows
+};
+
+struct TickerLoadResult {
+    PriceSeries series;
+    LoadStatus status = LoadStatus::NotFound;
+    std::string source;       // CSV path or download URL
+    bool fromAPI = false;     // no local CSV; source is the download URL
+    bool fromCache = false;   // served from the binary sidecar (see SeriesCache.h)
+    std::string error;        // detail when status != Ok
+};
 
 class StockDataLoader {
 public:
-    std::vector<StockData> LoadFromCSV(const std::string& filepath);
+    PriceSeries LoadFromCSV(const std::string& filepath);
 
-    std::vector<StockData> LoadFromAPI(
+    PriceSeries LoadFromAPI(
         const std::string& ticker,
         const std::string& startDate,
         const std::string& endDate);
 
     // Load stock data by ticker symbol - automatically finds or downloads CSV
-    std::vector<StockData> LoadByTicker(const std::string& ticker);
+    PriceSeries LoadByTicker(const std::string& ticker);
 
-private:
-    std::vector<StockData> ParseCSV(const std::string& csvContent);
-    std::string FetchFromURL(const std::string& url);
+    // Same lookup as LoadByTicker, but reports through the result instead of printing
+    TickerLoadResult LoadTicker(const std::string& ticker, bool allowFetch = true);
+
+    // Load many tickers at once. File discovery, parsing and API downloads run
+    // on a pool of at most maxWorkers threads (0 = one per hardware thread).
+    // Duplicate tickers are loaded once. Safe to call concurrently.
+    std::map<std::string, TickerLoadResult> LoadByTickers(
+        const std::vector<std::string>& tickers,
+        bool allowFetch = true,
+        size_t maxWorkers = 0);
+
+    // Path of the local CSV LoadTicker would read for ticker, or "" if none
     std::string FindTickerCSV(const std::string& ticker);
+
+private:
+    std::string FetchFromURL(const std::string& url, std::string& error);
+    PriceSeries DownloadTicker(const std::string& ticker, std::string& url, std::string& error);
 };
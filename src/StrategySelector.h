@@ -1,10 +1,15 @@
 #pragma once
 #include "AnalysisStrategy.h"
-#include "StockAnalytics.h"
+#include "BacktestKernel.h"
+#include "ThreadPool.h"
 #include <memory>
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
 
 // Result of strategy evaluation
 struct StrategyPerformance {
@@ -13,192 +18,184 @@ struct StrategyPerformance {
     double sharpeRatio;      // Risk-adjusted return
     double maxDrawdown;      // Worst drawdown (negative value)
     double winRate;          // Percentage of profitable signals
+    double turnover;         // Total |position change| over the backtest
     double score;            // Combined score for ranking
 };
 
+// Fill in a performance record from a backtest, including the composite
+// score used for ranking (higher is better):
+// 40% total return, 30% sharpe, 20% win rate, 10% drawdown
+inline StrategyPerformance MakePerformance(const std::string& name, const BacktestResult& result) {
+    StrategyPerformance perf;
+    perf.strategyName = name;
+    perf.totalReturn = result.totalReturn;
+    perf.sharpeRatio = result.sharpeRatio;
+    perf.maxDrawdown = result.maxDrawdown;
+    perf.winRate = result.winRate;
+    perf.turnover = result.turnover;
+    perf.score = (perf.totalReturn * 0.4) + 
+                 (perf.sharpeRatio * 0.3) + 
+                 (perf.winRate * 0.2) - 
+                 (perf.maxDrawdown * 0.1);
+    return perf;
+}
+
+// Outcome of one StrategySelector::evaluate call
+struct StrategyEvaluation {
+    std::vector<StrategyPerformance> ranking;  // best score first
+    AnalysisStrategy* best = nullptr;          // nullptr if no strategy scored
+    StrategyPerformance bestPerformance;
+};
+
 class StrategySelector {
 private:
-    StockAnalytics analytics;
+    int backtestWindow;  // bars of recent history each strategy is backtested on
     
     // Backtest a strategy on historical data
     StrategyPerformance backtestStrategy(
         AnalysisStrategy* strategy,
-        const std::vector<StockData>& data,
-        int lookbackWindow = 100  // How much history to evaluate
+        const PriceSeries& data,
+        int lookbackWindow  // How much history to evaluate
     ) {
         StrategyPerformance perf;
         perf.strategyName = strategy->getName();
         
-        if (data.size() < lookbackWindow + 20) {
+        if (data.size() < static_cast<size_t>(lookbackWindow) + 20) {
             // Not enough data for meaningful backtest
             perf.totalReturn = 0.0;
             perf.sharpeRatio = 0.0;
             perf.maxDrawdown = 0.0;
             perf.winRate = 0.0;
+            perf.turnover = 0.0;
             perf.score = 0.0;
             return perf;
         }
         
         // Use recent history for backtesting
         size_t startIdx = data.size() - lookbackWindow;
-        std::vector<StockData> backtestData(data.begin() + startIdx, data.end());
+        PriceSeries backtestData = data.Slice(startIdx, data.size());
         
-        // Special handling for Buy & Hold strategy
-        if (strategy->getName() == "Buy & Hold Strategy") {
-            // Buy at start, hold until end
-            double firstPrice = backtestData.front().close;
-            double lastPrice = backtestData.back().close;
-            
-            perf.totalReturn = (lastPrice - firstPrice) / firstPrice;
-            
-            // Calculate daily returns for Sharpe ratio
-            std::vector<double> dailyReturns;
-            for (size_t i = 1; i < backtestData.size(); ++i) {
-                double ret = (backtestData[i].close - backtestData[i-1].close) / backtestData[i-1].close;
-                dailyReturns.push_back(ret);
-            }
-            
-            perf.sharpeRatio = analytics.SharpeRatio(dailyReturns, 0.0);
-            
-            // Calculate max drawdown
-            double peak = backtestData[0].close;
-            double maxDD = 0.0;
-            for (const auto& point : backtestData) {
-                if (point.close > peak) peak = point.close;
-                double drawdown = (point.close - peak) / peak;
-                if (drawdown < maxDD) maxDD = drawdown;
-            }
-            perf.maxDrawdown = maxDD;
-            
-            // Win rate = % of positive days
-            int positiveDays = 0;
-            for (double ret : dailyReturns) {
-                if (ret > 0) positiveDays++;
+        // Point-in-time signals for every bar of the window; signal i only
+        // sees backtest bars [0, i]. The strategy's position rule turns them
+        // into positions, so buy-and-hold and active strategies share the
+        // same kernel. One virtual call per backtest: built-in strategies run
+        // it as a fused static loop, plugins through analyzeSeries.
+        BacktestResult result = strategy->backtest(backtestData);
+        return MakePerformance(perf.strategyName, result);
+    }
+    
+    // Memoized backtests, keyed by (strategy identity, column storage, first
+    // close, length, lookback), so a result is only reused for the same
+    // parameters on the same bars. An entry watches the storage through a
+    // weak_ptr: it never keeps a series alive, and once the storage is freed
+    // the entry cannot match whatever is later allocated at that address.
+    // At most kCacheLimit entries are kept, oldest evicted first.
+    struct CachedBacktest {
+        std::weak_ptr<const void> storage;
+        StrategyPerformance performance;
+    };
+    using CacheKey = std::tuple<std::string, const void*, const double*, size_t, int>;
+    static constexpr size_t kCacheLimit = 256;
+    std::map<CacheKey, CachedBacktest> cache;
+    std::deque<CacheKey> cacheOrder;  // insertion order, for eviction
+    
+public:
+    // Signals come from analyzeSeries in one pass, so long windows (years of
+    // daily bars) cost about as much as the default 100 days
+    explicit StrategySelector(int lookbackWindow = 100) : backtestWindow(lookbackWindow) {}
+    
+    // Backtest every strategy once and rank them. Strategies without a cached
+    // result for this series run concurrently on the shared thread pool (each
+    // strategy object is only used by one thread at a time). The best
+    // strategy is the first, in input order, with the highest score.
+    StrategyEvaluation evaluate(
+        std::vector<std::unique_ptr<AnalysisStrategy>>& strategies,
+        const PriceSeries& data
+    ) {
+        StrategyEvaluation evaluation;
+        evaluation.ranking.resize(strategies.size());
+        
+        std::vector<size_t> pending;
+        std::vector<CacheKey> keys(strategies.size());
+        for (size_t i = 0; i < strategies.size(); ++i) {
+            keys[i] = keyFor(*strategies[i], data);
+            auto hit = cacheable(keys[i]) ? cache.find(keys[i]) : cache.end();
+            if (hit != cache.end() && !hit->second.storage.expired()) {
+                evaluation.ranking[i] = hit->second.performance;
+            } else {
+                pending.push_back(i);
             }
-            perf.winRate = dailyReturns.empty() ? 0.0 : static_cast<double>(positiveDays) / dailyReturns.size();
-            
-            perf.score = (perf.totalReturn * 0.4) + 
-                         (perf.sharpeRatio * 0.3) + 
-                         (perf.winRate * 0.2) - 
-                         (perf.maxDrawdown * 0.1);
-            
-            return perf;
         }
         
-        // Simulate trading based on strategy signals (for active strategies)
-        std::vector<double> portfolioReturns;
-        int wins = 0;
-        int totalTrades = 0;
+        ParallelFor(pending.size(), [&](size_t p) {
+            size_t i = pending[p];
+            evaluation.ranking[i] = backtestStrategy(strategies[i].get(), data, backtestWindow);
+        });
         
-        for (size_t i = 20; i < backtestData.size() - 1; ++i) {
-            // Get signal from strategy using data up to point i
-            std::vector<StockData> historicalData(backtestData.begin(), backtestData.begin() + i + 1);
-            double signal = strategy->analyze(historicalData);
-            
-            // Calculate next-day return
-            double nextReturn = (backtestData[i+1].close - backtestData[i].close) / backtestData[i].close;
-            
-            // If signal is positive (buy signal), take the position
-            // If signal is negative (sell signal), inverse the return
-            double positionReturn = 0.0;
-            if (std::abs(signal) > 5.0) {  // Only trade on strong signals
-                totalTrades++;
-                positionReturn = (signal > 0) ? nextReturn : -nextReturn;
-                portfolioReturns.push_back(positionReturn);
-                
-                if (positionReturn > 0) wins++;
-            }
+        for (size_t i : pending) {
+            if (!cacheable(keys[i])) continue;
+            auto inserted = cache.insert_or_assign(keys[i], CachedBacktest{ data.Storage(), evaluation.ranking[i] });
+            if (inserted.second) cacheOrder.push_back(keys[i]);
+        }
+        while (cacheOrder.size() > kCacheLimit) {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
         }
         
-        // Calculate performance metrics
-        if (portfolioReturns.empty()) {
-            perf.totalReturn = 0.0;
-            perf.sharpeRatio = 0.0;
-            perf.maxDrawdown = 0.0;
-            perf.winRate = 0.0;
-        } else {
-            // Total return (compounded)
-            perf.totalReturn = 0.0;
-            for (double r : portfolioReturns) {
-                perf.totalReturn += r;
-            }
-            
-            // Sharpe ratio
-            perf.sharpeRatio = analytics.SharpeRatio(portfolioReturns, 0.0);
-            
-            // Max drawdown from equity curve
-            std::vector<double> equityCurve;
-            double cumReturn = 1.0;
-            for (double r : portfolioReturns) {
-                cumReturn *= (1.0 + r);
-                equityCurve.push_back(cumReturn);
-            }
-            
-            double peak = equityCurve[0];
-            double maxDD = 0.0;
-            for (double equity : equityCurve) {
-                if (equity > peak) peak = equity;
-                double drawdown = (equity - peak) / peak;
-                if (drawdown < maxDD) maxDD = drawdown;
+        double bestScore = -1e9;
+        for (size_t i = 0; i < strategies.size(); ++i) {
+            if (evaluation.ranking[i].score > bestScore) {
+                bestScore = evaluation.ranking[i].score;
+                evaluation.best = strategies[i].get();
+                evaluation.bestPerformance = evaluation.ranking[i];
             }
-            perf.maxDrawdown = maxDD;
-            
-            // Win rate
-            perf.winRate = (totalTrades > 0) ? (static_cast<double>(wins) / totalTrades) : 0.0;
         }
         
-        // Calculate composite score (higher is better)
-        // Weight: 40% total return, 30% sharpe, 20% win rate, 10% drawdown
-        perf.score = (perf.totalReturn * 0.4) + 
-                     (perf.sharpeRatio * 0.3) + 
-                     (perf.winRate * 0.2) - 
-                     (perf.maxDrawdown * 0.1);
+        // Sort by score (best first); ties keep input order
+        std::stable_sort(evaluation.ranking.begin(), evaluation.ranking.end(),
+                         [](const StrategyPerformance& a, const StrategyPerformance& b) {
+                             return a.score > b.score;
+                         });
         
-        return perf;
+        return evaluation;
     }
     
-public:
     // Select the best strategy from a list of candidates
     AnalysisStrategy* selectBestStrategy(
         std::vector<std::unique_ptr<AnalysisStrategy>>& strategies,
-        const std::vector<StockData>& data,
+        const PriceSeries& data,
         StrategyPerformance& bestPerformance
     ) {
-        if (strategies.empty()) return nullptr;
-        
-        AnalysisStrategy* bestStrategy = nullptr;
-        double bestScore = -1e9;
-        
-        for (auto& strategy : strategies) {
-            StrategyPerformance perf = backtestStrategy(strategy.get(), data);
-            
-            if (perf.score > bestScore) {
-                bestScore = perf.score;
-                bestStrategy = strategy.get();
-                bestPerformance = perf;
-            }
-        }
-        
-        return bestStrategy;
+        StrategyEvaluation evaluation = evaluate(strategies, data);
+        if (evaluation.best) bestPerformance = evaluation.bestPerformance;
+        return evaluation.best;
     }
     
-    // Evaluate all strategies and return performance metrics
+    // Evaluate all strategies and return performance metrics, best first
     std::vector<StrategyPerformance> evaluateAllStrategies(
         std::vector<std::unique_ptr<AnalysisStrategy>>& strategies,
-        const std::vector<StockData>& data
+        const PriceSeries& data
     ) {
-        std::vector<StrategyPerformance> performances;
-        
-        for (auto& strategy : strategies) {
-            performances.push_back(backtestStrategy(strategy.get(), data));
-        }
-        
-        // Sort by score (best first)
-        std::sort(performances.begin(), performances.end(),
-                  [](const StrategyPerformance& a, const StrategyPerformance& b) {
-                      return a.score > b.score;
-                  });
-        
-        return performances;
+        return evaluate(strategies, data).ranking;
+    }
+    
+    // Drop memoized backtests
+    void clearCache() {
+        cache.clear();
+        cacheOrder.clear();
+    }
+    
+    size_t cacheSize() const { return cache.size(); }
+    
+private:
+    CacheKey keyFor(const AnalysisStrategy& strategy, const PriceSeries& data) const {
+        return CacheKey(strategy.cacheIdentity(), data.Storage().get(), data.Close().data(), data.size(),
+                        backtestWindow);
+    }
+    
+    // Strategies without an identity, and series without storage to watch,
+    // are always backtested
+    static bool cacheable(const CacheKey& key) {
+        return !std::get<0>(key).empty() && std::get<1>(key) != nullptr;
     }
 };
@@ -0,0 +1,358 @@
+#include "StreamEngine.h"
+#include "TradingDate.h"
+#include "UnixSocket.h"
+#include "Universe.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t gSignalled = 0;
+
+void OnSignal(int) { gSignalled = 1; }
+
+// Zone label for a signal, or nullptr while the strategy is still warming up
+const char* Zone(double signal) {
+    return std::isnan(signal) ? nullptr : SignalAction(signal);
+}
+
+bool ParseNumber(std::string_view text, double& value) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\r')) text.remove_suffix(1);
+    if (text.empty()) return false;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+std::string_view TrimField(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+} // namespace
+
+// ------------------- Engine -------------------
+
+bool StreamEngine::OnBar(const StreamBar& bar, std::chrono::steady_clock::time_point received) {
+    if (bar.ticker.empty() || !(bar.close > 0.0) || !std::isfinite(bar.close)) {
+        Reject();
+        return false;
+    }
+
+    key_.assign(bar.ticker.data(), bar.ticker.size());
+    TickerState& state = tickers_[key_];
+    StreamSnapshot& snap = state.snapshot;
+    if (snap.bars > 0 && bar.date <= snap.date) {
+        Reject();
+        return false;
+    }
+
+    const double close = bar.close;
+    snap.date = bar.date;
+    snap.close = close;
+    ++snap.bars;
+    snap.sma20 = state.sma.Update(close);
+    snap.volatility20 = state.volatility.Update(state.returns.Update(close));
+    state.bollinger.Update(close);
+    snap.bollingerMiddle = state.bollinger.middle();
+    snap.bollingerUpper = state.bollinger.upper();
+    snap.bollingerLower = state.bollinger.lower();
+    snap.trendingSignal = state.trending.Step(close);
+    snap.meanReversionSignal = state.meanReversion.Step(close);
+
+    // Crossings are decided before any event is handed out, so the latency
+    // covers the engine's work and not the consumer's
+    const double signals[2] = { snap.trendingSignal, snap.meanReversionSignal };
+    const char* names[2] = { TrendingSignal::Name(), MeanReversionSignal::Name() };
+    const char* previous[2] = { state.zones[0], state.zones[1] };
+    bool crossed[2];
+    for (int s = 0; s < 2; ++s) {
+        const char* zone = Zone(signals[s]);
+        crossed[s] = previous[s] != nullptr && zone != nullptr && zone != previous[s];
+        if (zone != nullptr) state.zones[s] = zone;
+    }
+    double latencyUs = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - received).count();
+    latencyUs_.Add(latencyUs);
+
+    for (int s = 0; s < 2; ++s) {
+        if (!crossed[s]) continue;
+        ++events_;
+        if (onEvent_) {
+            onEvent_(SignalEvent{ key_, bar.date, names[s], previous[s], state.zones[s],
+                                  signals[s], close, latencyUs });
+        }
+    }
+    if (onBar_) onBar_(true);
+    return true;
+}
+
+bool StreamEngine::OnLine(std::string_view line, std::string& error) {
+    auto received = std::chrono::steady_clock::now();
+    std::string_view trimmed = TrimField(line);
+    if (trimmed.empty() || trimmed.front() == '#') return true;
+
+    std::string_view fields[7];
+    size_t count = 0;
+    while (count < 7) {
+        size_t comma = trimmed.find(',');
+        fields[count++] = TrimField(trimmed.substr(0, comma));
+        if (comma == std::string_view::npos) {
+            trimmed = std::string_view();
+            break;
+        }
+        trimmed.remove_prefix(comma + 1);
+    }
+
+    StreamBar bar{};
+    bool ok = (count == 3 || count == 7) && trimmed.empty() && !fields[0].empty() &&
+              ParseDate(fields[1], bar.date);
+    if (ok && count == 3) {
+        ok = ParseNumber(fields[2], bar.close);
+        bar.open = bar.high = bar.low = bar.close;
+    } else if (ok) {
+        ok = ParseNumber(fields[2], bar.open) && ParseNumber(fields[3], bar.high) &&
+             ParseNumber(fields[4], bar.low) && ParseNumber(fields[5], bar.close) &&
+             ParseNumber(fields[6], bar.volume);
+    }
+    if (!ok) {
+        error = "malformed bar '" + std::string(TrimField(line)) + "'";
+        Reject();
+        return false;
+    }
+    bar.ticker = fields[0];
+    return OnBar(bar, received);
+}
+
+bool StreamEngine::OnRecord(const StreamBarRecord& record) {
+    auto received = std::chrono::steady_clock::now();
+    size_t length = 0;
+    while (length < sizeof(record.ticker) && record.ticker[length] != '\0') ++length;
+    StreamBar bar{ std::string_view(record.ticker, length), record.date,
+                   record.open, record.high, record.low, record.close, record.volume };
+    return OnBar(bar, received);
+}
+
+const StreamSnapshot* StreamEngine::Snapshot(const std::string& ticker) const {
+    auto it = tickers_.find(ticker);
+    return it == tickers_.end() ? nullptr : &it->second.snapshot;
+}
+
+StreamStats StreamEngine::Stats() const {
+    StreamStats stats;
+    stats.bars = latencyUs_.count();
+    stats.rejected = rejected_;
+    stats.tickers = tickers_.size();
+    stats.events = events_;
+
+    LatencySummary latency = latencyUs_.Summary();
+    stats.latencyP50Us = latency.p50;
+    stats.latencyP99Us = latency.p99;
+    stats.latencyMaxUs = latency.max;
+    stats.latencyMeanUs = latency.mean;
+    return stats;
+}
+
+LatencySummary SummarizeLatencies(std::vector<float>& samples) {
+    LatencySummary summary;
+    if (samples.empty()) return summary;
+
+    double sum = 0.0;
+    for (float v : samples) sum += v;
+    summary.mean = sum / static_cast<double>(samples.size());
+
+    // Ascending quantiles, so each nth_element only partitions what is
+    // right of the previous one
+    auto begin = samples.begin();
+    auto at = [&](double q) {
+        auto k = samples.begin() + static_cast<std::ptrdiff_t>(q * static_cast<double>(samples.size() - 1));
+        std::nth_element(begin, k, samples.end());
+        begin = k;
+        return static_cast<double>(*k);
+    };
+    summary.p50 = at(0.50);
+    summary.p90 = at(0.90);
+    summary.p99 = at(0.99);
+    summary.p999 = at(0.999);
+    summary.max = *std::max_element(begin, samples.end());
+    return summary;
+}
+
+void LatencyHistogram::Add(double us) {
+    ++count_;
+    sum_ += us;
+    if (us > max_) max_ = us;
+
+    // frexp gives us = m * 2^e with m in [0.5, 1): the octave is e - 1 and
+    // the sub-bucket the position of 2m in [1, 2)
+    size_t index = 0;
+    if (us >= std::ldexp(1.0, kMinExponent)) {
+        int exponent;
+        double mantissa = std::frexp(us, &exponent);
+        int octave = exponent - 1 - kMinExponent;
+        int sub = static_cast<int>((mantissa * 2.0 - 1.0) * kSubBuckets);
+        index = std::min(kBuckets - 1, 1 + static_cast<size_t>(octave * kSubBuckets + sub));
+    }
+    ++counts_[index];
+}
+
+double LatencyHistogram::Quantile(double q) const {
+    const double rank = q * static_cast<double>(count_ - 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts_[i];
+        if (static_cast<double>(seen) <= rank) continue;
+        if (i == 0) return std::min(max_, std::ldexp(0.5, kMinExponent));
+        if (i == kBuckets - 1) return max_;
+        int octave = static_cast<int>((i - 1) / kSubBuckets) + kMinExponent;
+        double sub = static_cast<double>((i - 1) % kSubBuckets);
+        return std::min(max_, std::ldexp(1.0 + (sub + 0.5) / kSubBuckets, octave));
+    }
+    return max_;
+}
+
+LatencySummary LatencyHistogram::Summary() const {
+    LatencySummary summary;
+    if (count_ == 0) return summary;
+    summary.p50 = Quantile(0.50);
+    summary.p90 = Quantile(0.90);
+    summary.p99 = Quantile(0.99);
+    summary.p999 = Quantile(0.999);
+    summary.max = max_;
+    summary.mean = sum_ / static_cast<double>(count_);
+    return summary;
+}
+
+// ------------------- Decoding -------------------
+
+void StreamDecoder::Feed(const char* data, size_t size,
+                         const std::function<void(const std::string&)>& onError) {
+    pending_.append(data, size);
+
+    if (mode_ == Mode::Unknown) {
+        // Decide once enough bytes are in to compare against the magic
+        size_t n = std::min(pending_.size(), sizeof(kStreamBinaryMagic));
+        if (std::memcmp(pending_.data(), kStreamBinaryMagic, n) != 0) {
+            mode_ = Mode::Line;
+        } else if (n == sizeof(kStreamBinaryMagic)) {
+            mode_ = Mode::Binary;
+            pending_.erase(0, sizeof(kStreamBinaryMagic));
+        } else {
+            return;
+        }
+    }
+
+    size_t used = 0;
+    if (mode_ == Mode::Binary) {
+        StreamBarRecord record;
+        while (pending_.size() - used >= sizeof(record)) {
+            std::memcpy(&record, pending_.data() + used, sizeof(record));
+            engine_.OnRecord(record);
+            used += sizeof(record);
+        }
+    } else {
+        std::string error;
+        size_t newline;
+        while ((newline = pending_.find('\n', used)) != std::string::npos) {
+            if (skipping_) {
+                skipping_ = false;
+            } else if (!engine_.OnLine(std::string_view(pending_).substr(used, newline - used), error) &&
+                       onError && !error.empty()) {
+                onError(error);
+            }
+            error.clear();
+            used = newline + 1;
+        }
+        if (pending_.size() - used > kMaxLineBytes) {
+            if (!skipping_ && onError) {
+                onError("line longer than " + std::to_string(kMaxLineBytes) + " bytes dropped");
+            }
+            skipping_ = true;
+            used = pending_.size();
+        }
+    }
+    pending_.erase(0, used);
+}
+
+void StreamDecoder::Finish(const std::function<void(const std::string&)>& onError) {
+    if (mode_ == Mode::Line && !pending_.empty() && !skipping_) {
+        std::string error;
+        if (!engine_.OnLine(pending_, error) && onError && !error.empty()) onError(error);
+    }
+    pending_.clear();
+    skipping_ = false;
+}
+
+// ------------------- Input -------------------
+
+void RunStream(StreamEngine& engine, int fd, const std::function<void(const std::string&)>& onError) {
+    StreamDecoder decoder(engine);
+    char buf[65536];
+    while (true) {
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        decoder.Feed(buf, static_cast<size_t>(n), onError);
+    }
+    decoder.Finish(onError);
+}
+
+int ServeStream(StreamEngine& engine, const std::string& socketPath, std::string& error,
+                const std::function<void(const std::string&)>& onError) {
+    int listener = ListenUnixSocket(socketPath, error);
+    if (listener < 0) return 1;
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    // One thread polls the listener and every producer, so bars reach the
+    // engine in arrival order without any locking
+    std::vector<pollfd> fds{ pollfd{ listener, POLLIN, 0 } };
+    std::vector<std::unique_ptr<StreamDecoder>> decoders(1);
+    char buf[65536];
+    while (!gSignalled) {
+        int ready = ::poll(fds.data(), fds.size(), 250);
+        if (ready <= 0) continue;
+
+        for (size_t i = fds.size(); i-- > 1;) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = ::recv(fds[i].fd, buf, sizeof(buf), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n > 0) {
+                decoders[i]->Feed(buf, static_cast<size_t>(n), onError);
+                continue;
+            }
+            decoders[i]->Finish(onError);
+            ::close(fds[i].fd);
+            fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i));
+            decoders.erase(decoders.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int client = ::accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                fds.push_back(pollfd{ client, POLLIN, 0 });
+                decoders.push_back(std::make_unique<StreamDecoder>(engine));
+            }
+        }
+    }
+
+    for (size_t i = 1; i < fds.size(); ++i) {
+        decoders[i]->Finish(onError);
+        ::close(fds[i].fd);
+    }
+    ::close(listener);
+    RemoveUnixSocket(socketPath);
+    return 0;
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "OnlineIndicators.h"
+#include "StaticStrategy.h"
+
+// Incremental analysis of bars as they arrive (`stocks --stream`).
+//
+// Each ticker keeps online indicator state (20-day SMA, volatility and
+// Bollinger bands) and the online form of the trending and mean-reversion
+// strategies (see StaticStrategy.h), so a bar costs O(1) regardless of how
+// much history came before it. The signals are the same values the batch
+// strategies compute at the same bar.
+//
+// Whenever a strategy's signal crosses into another action zone (the +/-5 and
+// +/-10 thresholds of SignalAction: STRONG BUY, BUY, HOLD / NEUTRAL, SELL,
+// STRONG SELL) a SignalEvent is emitted. The zone a strategy settles in once
+// it has warmed up is its starting point, not an event.
+//
+// Input protocols (see StreamDecoder):
+//   line    one bar per line, "TICKER,DATE,OPEN,HIGH,LOW,CLOSE,VOLUME" or
+//           "TICKER,DATE,CLOSE"; DATE as in the CSVs (YYYY-MM-DD); blank
+//           lines and lines starting with '#' are skipped
+//   binary  the 4 bytes "SSB1", then StreamBarRecord structs back to back
+
+struct StreamBar {
+    std::string_view ticker;
+    int32_t date;                  // days since 1970-01-01
+    double open, high, low, close, volume;
+};
+
+// Wire format of one binary bar (host byte order, 56 bytes)
+struct StreamBarRecord {
+    char ticker[8];                // NUL-padded; a full 8 characters has no NUL
+    int32_t date;
+    uint32_t reserved;             // 0
+    double open, high, low, close, volume;
+};
+static_assert(sizeof(StreamBarRecord) == 56, "StreamBarRecord must be packed to 56 bytes");
+
+constexpr char kStreamBinaryMagic[4] = { 'S', 'S', 'B', '1' };
+
+// A strategy moved from one action zone to another
+struct SignalEvent {
+    std::string ticker;
+    int32_t date;
+    const char* strategy;          // TrendingSignal::Name(), ...
+    const char* from;              // previous SignalAction label
+    const char* to;                // new SignalAction label
+    double signal;
+    double close;
+    double latencyUs;              // bar decoded to event decided
+};
+
+// Latest state of one ticker
+struct StreamSnapshot {
+    int32_t date = 0;
+    size_t bars = 0;
+    double close = 0.0;
+    double sma20, volatility20;
+    double bollingerMiddle, bollingerUpper, bollingerLower;
+    double trendingSignal, meanReversionSignal;
+};
+
+struct StreamStats {
+    size_t bars = 0;               // accepted
+    size_t rejected = 0;           // malformed, non-positive close, or not after the ticker's last bar
+    size_t tickers = 0;
+    size_t events = 0;
+    double latencyP50Us = 0.0;     // per accepted bar: decode + update + crossing check
+                                   // (LatencyHistogram precision)
+    double latencyP99Us = 0.0;
+    double latencyMaxUs = 0.0;
+    double latencyMeanUs = 0.0;
+};
+
+// Percentiles of a set of latencies in microseconds
+struct LatencySummary {
+    double p50 = 0.0, p90 = 0.0, p99 = 0.0, p999 = 0.0;
+    double max = 0.0, mean = 0.0;
+};
+
+// Summarize samples (reordered in place); all zero when there are none
+LatencySummary SummarizeLatencies(std::vector<float>& samples);
+
+// Latency distribution in constant memory, for engines that run
+// indefinitely. Buckets split each power of two from 2^-7 us to 2^24 us
+// (about 17 s) into 16 equal steps; a quantile is reported as the middle of
+// its bucket, within about 3% of the exact value. Count, mean and max are
+// exact.
+class LatencyHistogram {
+public:
+    void Add(double us);
+    size_t count() const { return count_; }
+    LatencySummary Summary() const;
+
+private:
+    static constexpr int kSubBuckets = 16;
+    static constexpr int kMinExponent = -7;
+    static constexpr int kMaxExponent = 24;
+    // Bucket 0 holds everything below 2^kMinExponent, the last everything above
+    static constexpr size_t kBuckets = (kMaxExponent - kMinExponent) * kSubBuckets + 2;
+
+    double Quantile(double q) const;
+
+    std::array<uint64_t, kBuckets> counts_{};
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double max_ = 0.0;
+};
+
+class StreamEngine {
+public:
+    using EventHandler = std::function<void(const SignalEvent&)>;
+    using BarHandler = std::function<void(bool accepted)>;
+
+    explicit StreamEngine(EventHandler onEvent) : onEvent_(std::move(onEvent)) {}
+
+    // Called once for every bar OnBar handles, accepted or rejected, after
+    // its events (ReplayEngine times bars end to end with it)
+    void SetBarHandler(BarHandler onBar) { onBar_ = std::move(onBar); }
+
+    // Update the bar's ticker and emit any crossings. received is when the bar
+    // arrived, for the latency measurement. Returns false (and counts the bar
+    // as rejected) unless the close is positive and the date is after the
+    // ticker's previous bar.
+    bool OnBar(const StreamBar& bar,
+               std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now());
+
+    // Parse one line-protocol bar and process it. Blank and comment lines
+    // return true without doing anything; a malformed line sets error.
+    bool OnLine(std::string_view line, std::string& error);
+
+    // Decode one binary record and process it
+    bool OnRecord(const StreamBarRecord& record);
+
+    // Latest state of ticker, or nullptr if no bar has been accepted for it
+    const StreamSnapshot* Snapshot(const std::string& ticker) const;
+
+    StreamStats Stats() const;
+
+private:
+    struct TickerState {
+        TrendingSignal trending;
+        MeanReversionSignal meanReversion;
+        OnlineSMA sma{20};
+        OnlineReturn returns;
+        OnlineVolatility volatility{20};
+        OnlineBollinger bollinger{20};
+        const char* zones[2] = { nullptr, nullptr };  // per strategy; nullptr while warming up
+        StreamSnapshot snapshot;
+    };
+
+    void Reject() {
+        ++rejected_;
+        if (onBar_) onBar_(false);
+    }
+
+    EventHandler onEvent_;
+    BarHandler onBar_;
+    std::unordered_map<std::string, TickerState> tickers_;
+    std::string key_;                     // reused lookup key, avoids a string per bar
+    LatencyHistogram latencyUs_;          // bounded, however long the stream runs
+    size_t rejected_ = 0;
+    size_t events_ = 0;
+};
+
+// Splits a byte stream into bars for a StreamEngine. The first bytes decide
+// the protocol: the binary magic, or else lines. Partial lines and records
+// are kept until the rest arrives.
+class StreamDecoder {
+public:
+    explicit StreamDecoder(StreamEngine& engine) : engine_(engine) {}
+
+    // Consume the next chunk of input; malformed lines are reported through
+    // onError (with their text) and skipped, as is any line longer than
+    // kMaxLineBytes (so a stream without newlines cannot grow the buffer)
+    void Feed(const char* data, size_t size,
+              const std::function<void(const std::string&)>& onError = nullptr);
+
+    // End of input: a final line without a newline is still processed
+    void Finish(const std::function<void(const std::string&)>& onError = nullptr);
+
+    bool binary() const { return mode_ == Mode::Binary; }
+
+    static constexpr size_t kMaxLineBytes = 65536;
+
+private:
+    enum class Mode { Unknown, Line, Binary };
+
+    StreamEngine& engine_;
+    Mode mode_ = Mode::Unknown;
+    std::string pending_;
+    bool skipping_ = false;  // dropping the rest of an overlong line
+};
+
+// Read bars from fd until end of input
+void RunStream(StreamEngine& engine, int fd,
+               const std::function<void(const std::string&)>& onError = nullptr);
+
+// Listen on a Unix socket and read bars from any number of producers until
+// SIGINT / SIGTERM; each connection gets its own decoder, and all of them
+// feed the one engine from a single thread, in arrival order. Returns 0, or
+// 1 with error set if the socket could not be set up.
+int ServeStream(StreamEngine& engine, const std::string& socketPath, std::string& error,
+                const std::function<void(const std::string&)>& onError = nullptr);
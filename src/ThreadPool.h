@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size work-stealing pool.
+//
+// Every worker owns a deque. Tasks submitted from inside a worker go to the
+// back of that worker's deque and are popped LIFO (cache-warm, and nested
+// ParallelFor helpers stay close to their parent); tasks submitted from other
+// threads go to a shared injection queue that is served FIFO, so batches keep
+// their submission order. An idle worker takes from its own deque, then the
+// injection queue, then steals from the front of the other deques, so one
+// long task never leaves queued work stranded behind it.
+// The destructor finishes every queued task before joining the workers.
+class ThreadPool {
+public:
+    // threads == 0 uses one worker per hardware thread
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = DefaultThreadCount();
+        queues_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Queue f for execution; the future carries its result or exception
+    template <typename F>
+    std::future<std::invoke_result_t<F>> Submit(F&& f) {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> future = task->get_future();
+
+        {
+            WorkerQueue& queue = currentPool_ == this ? *queues_[currentWorker_] : injected_;
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.emplace_back([task] { (*task)(); });
+        }
+        {
+            // Counted under mutex_ so a worker about to sleep cannot miss it
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++pending_;
+        }
+        wake_.notify_one();
+        return future;
+    }
+
+    static size_t DefaultThreadCount() {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Own deque from the back, then the injection queue and the other deques
+    // from the front
+    bool TryTake(size_t self, std::function<void()>& task) {
+        {
+            WorkerQueue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 0; k < queues_.size(); ++k) {
+            WorkerQueue& victim = k == 0 ? injected_ : *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t self) {
+        currentPool_ = this;
+        currentWorker_ = self;
+        while (true) {
+            std::function<void()> task;
+            if (TryTake(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    --pending_;
+                }
+                task();
+                continue;
+            }
+            // pending_ can briefly count a task another worker has already
+            // taken; the wait below then returns at once and we retry
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+            if (stopping_ && pending_ <= 0) return;  // stopping and drained
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    WorkerQueue injected_;  // tasks submitted from outside the pool
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    long pending_ = 0;  // queued, not yet taken; guarded by mutex_ (briefly < 0
+                        // when a task is taken before its Submit counts it)
+    bool stopping_ = false;
+
+    // Pool and deque index of the calling thread, when it is a worker
+    static inline thread_local const ThreadPool* currentPool_ = nullptr;
+    static inline thread_local size_t currentWorker_ = 0;
+};
+
+// Process-wide pool for data-parallel analytics, created on first use
+inline ThreadPool& SharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// Run body(i) for every i in [0, count), spreading iterations over the calling
+// thread and the pool's workers. Iterations are claimed one at a time from a
+// shared counter, so uneven iterations balance themselves.
+//
+// The caller works through the range too and only waits for iterations that a
+// worker has already claimed. Helpers that start after the range is exhausted
+// exit immediately. This makes ParallelFor safe to nest inside pool tasks: it
+// degrades to a serial loop when every worker is busy instead of deadlocking.
+// The first exception thrown by body is rethrown on the calling thread.
+template <typename Body>
+void ParallelFor(size_t count, Body&& body, ThreadPool& pool = SharedThreadPool()) {
+    if (count == 0) return;
+    if (count == 1 || pool.size() == 0) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        size_t count = 0;
+        std::function<void(size_t)> body;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->body = std::forward<Body>(body);
+
+    auto work = [state] {
+        size_t i;
+        while ((i = state->next.fetch_add(1)) < state->count) {
+            try {
+                state->body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            if (state->done.fetch_add(1) + 1 == state->count) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(pool.size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) pool.Submit(work);
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->done.load() == state->count; });
+    if (state->error) std::rethrow_exception(state->error);
+}
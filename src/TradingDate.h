@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Dates are stored as int32 days since 1970-01-01 (the Unix epoch), so
+// comparing, sorting and aligning bars is plain integer arithmetic. Text is
+// only produced when printing.
+
+// Days since the epoch for a proleptic Gregorian date (H. Hinnant's algorithm)
+constexpr int32_t DaysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int32_t>(era * 146097 + static_cast<int>(doe) - 719468);
+}
+
+// Inverse of DaysFromCivil
+constexpr void CivilFromDays(int32_t days, int& year, unsigned& month, unsigned& day) {
+    const int z = days + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe) + era * 400 + (month <= 2);
+}
+
+namespace detail {
+
+inline bool ParseDigits(std::string_view s, size_t pos, size_t count, unsigned& value) {
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        unsigned digit = static_cast<unsigned>(s[i] - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+inline bool IsLeapYear(unsigned year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+} // namespace detail
+
+// Parse the calendar part of a date field into days since the epoch.
+// Accepts ISO "YYYY-MM-DD" (as written by Yahoo and fetch_api.py) and
+// day-first "DD-MM-YYYY" (as in the bundled AAPL.csv); '/' also works as the
+// separator. Anything after the date, such as " 00:00:00+00:00" or "T00:00", is
+// ignored.
+inline bool ParseDate(std::string_view text, int32_t& days) {
+    if (text.size() < 10) return false;
+    if (text.size() > 10 && text[10] != ' ' && text[10] != 'T') return false;
+
+    unsigned year, month, day;
+    char sep = text[4];
+    if (sep == '-' || sep == '/') {
+        if (text[7] != sep ||
+            !detail::ParseDigits(text, 0, 4, year) ||
+            !detail::ParseDigits(text, 5, 2, month) ||
+            !detail::ParseDigits(text, 8, 2, day)) {
+            return false;
+        }
+    } else {
+        sep = text[2];
+        if ((sep != '-' && sep != '/') || text[5] != sep ||
+            !detail::ParseDigits(text, 0, 2, day) ||
+            !detail::ParseDigits(text, 3, 2, month) ||
+            !detail::ParseDigits(text, 6, 4, year)) {
+            return false;
+        }
+    }
+
+    static const unsigned char kMonthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12 || day < 1) return false;
+    unsigned maxDay = kMonthDays[month - 1] + (month == 2 && detail::IsLeapYear(year));
+    if (day > maxDay) return false;
+
+    days = DaysFromCivil(static_cast<int>(year), month, day);
+    return true;
+}
+
+// Write days as "YYYY-MM-DD" into out (exactly 10 characters, no terminator)
+inline void FormatDate(int32_t days, char* out) {
+    int year;
+    unsigned month, day;
+    CivilFromDays(days, year, month, day);
+    unsigned y = static_cast<unsigned>(year);
+    out[0] = static_cast<char>('0' + y / 1000 % 10);
+    out[1] = static_cast<char>('0' + y / 100 % 10);
+    out[2] = static_cast<char>('0' + y / 10 % 10);
+    out[3] = static_cast<char>('0' + y % 10);
+    out[4] = '-';
+    out[5] = static_cast<char>('0' + month / 10);
+    out[6] = static_cast<char>('0' + month % 10);
+    out[7] = '-';
+    out[8] = static_cast<char>('0' + day / 10);
+    out[9] = static_cast<char>('0' + day % 10);
+}
+
+inline std::string FormatDate(int32_t days) {
+    char buf[10];
+    FormatDate(days, buf);
+    return std::string(buf, sizeof(buf));
+}
@@ -1,27 +1,52 @@
 #pragma once
 #include "AnalysisStrategy.h"
-#include "StockAnalytics.h"
+#include "StaticStrategy.h"
+#include <limits>
 
 // Strategy for trending/momentum stocks (H > 0.5)
 class TrendingStrategy : public AnalysisStrategy {
 private:
-    StockAnalytics analytics;
+    int smaWindow;     // long-term average the price is compared against
+    double threshold;  // |signal| needed to take a position
     
 public:
-    double analyze(const std::vector<StockData>& data) override {
-        // For trending stocks: Use momentum indicators
-        auto returns = analytics.DailyReturns(data);
-        auto sma50 = analytics.SimpleMovingAverage(data, 50);
-        
-        // Simple momentum score: current price vs long-term average
-        double currentPrice = data.back().close;
-        double longTermAvg = sma50.back();
-        
-        // Positive if above average (buy signal), negative if below
-        return (currentPrice - longTermAvg) / longTermAvg * 100.0;
+    explicit TrendingStrategy(int smaWindow = 50, double threshold = 5.0)
+        : smaWindow(smaWindow), threshold(threshold) {}
+    
+
+    // Signals come from the same running-sum SMA as backtest() (TrendingSignal,
+    // OnlineSMA) rather than the vectorized SimpleMovingAverage, whose prefix
+    // scan rounds differently: the reported signal is then bit for bit the one
+    // the backtest traded on, even right at the threshold.
+    double analyze(const PriceSeries& data) override {
+        // Momentum score: current price vs long-term average, positive if
+        // above average (buy signal), negative if below
+        TrendingSignal signal(smaWindow, threshold);
+        double current = std::numeric_limits<double>::quiet_NaN();
+        for (double price : data.Close()) current = signal.Step(price);
+        return current;
+    }
+    
+    std::vector<double> analyzeSeries(const PriceSeries& data) override {
+        // The SMA is causal, so one pass gives the signal at every bar
+        // (NaN until smaWindow bars of history exist)
+        return TrendingSignal(smaWindow, threshold).Signals(data);
+    }
+    
+    PositionRule positionRule() const override {
+        return PositionRule::Threshold(threshold);
+    }
+    
+    // One fused, non-virtual pass (see StaticStrategy.h)
+    BacktestResult backtest(const PriceSeries& data) override {
+        return TrendingSignal(smaWindow, threshold).Backtest(data);
     }
     
     std::string getName() const override {
         return "Momentum/Trending Strategy";
     }
+
+    std::string cacheIdentity() const override {
+        return getName() + "(" + std::to_string(smaWindow) + "," + std::to_string(threshold) + ")";
+    }
 };
\ No newline at end of file
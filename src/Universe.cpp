@@ -0,0 +1,341 @@
+#include "Universe.h"
+#include "JsonWriter.h"
+#include "TradingDate.h"
+#include "BuyAndHoldStrategy.h"
+#include "MeanReversionStrategy.h"
+#include "TrendingStrategy.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Indicators, selection and signal for analysis.load.series
+void Analyze(TickerAnalysis& analysis) {
+    const PriceSeries& data = analysis.load.series;
+
+    IndicatorPipeline pipeline;
+    analysis.indicators = pipeline.Run(data);
+
+    analysis.signal = std::numeric_limits<double>::quiet_NaN();
+    analysis.strategies = DefaultStrategies();
+    if (data.empty()) return;
+
+    StrategySelector selector;
+    analysis.evaluation = selector.evaluate(analysis.strategies, data);
+    if (analysis.evaluation.best) {
+        analysis.signal = analysis.evaluation.best->analyze(data);
+    }
+}
+
+std::string Trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+} // namespace
+
+std::vector<std::unique_ptr<AnalysisStrategy>> DefaultStrategies() {
+    std::vector<std::unique_ptr<AnalysisStrategy>> strategies;
+    strategies.push_back(std::make_unique<TrendingStrategy>());
+    strategies.push_back(std::make_unique<MeanReversionStrategy>());
+    strategies.push_back(std::make_unique<BuyAndHoldStrategy>());
+    return strategies;
+}
+
+TickerAnalysis AnalyzeSeries(const std::string& ticker, const PriceSeries& data) {
+    auto start = std::chrono::steady_clock::now();
+    TickerAnalysis analysis;
+    analysis.ticker = ticker;
+    analysis.load.series = data;
+    analysis.load.status = LoadStatus::Ok;
+    Analyze(analysis);
+    analysis.elapsedMs = MillisecondsSince(start);
+    return analysis;
+}
+
+TickerAnalysis AnalyzeTicker(StockDataLoader& loader, const std::string& ticker, bool allowFetch) {
+    auto start = std::chrono::steady_clock::now();
+    TickerAnalysis analysis;
+    analysis.ticker = TickerName(ticker);
+    analysis.signal = std::numeric_limits<double>::quiet_NaN();
+    analysis.load = loader.LoadTicker(ticker, allowFetch);
+    if (analysis.load.status == LoadStatus::Ok) {
+        Analyze(analysis);
+    }
+    analysis.elapsedMs = MillisecondsSince(start);
+    return analysis;
+}
+
+const char* SignalAction(double signal) {
+    if (signal > 10.0) return "STRONG BUY";
+    if (signal > 5.0) return "BUY";
+    if (signal > -5.0) return "HOLD / NEUTRAL";
+    if (signal > -10.0) return "SELL";
+    return "STRONG SELL";
+}
+
+const char* BollingerStatus(double close, double middle, double upper, double lower) {
+    // Within 15% of the band width from either band counts as at that band
+    double nearBand = (upper - lower) * 0.15;
+    if (upper - close < nearBand) return "OVERBOUGHT";
+    if (close - lower < nearBand) return "OVERSOLD";
+    if (close > middle) return "Slightly Overbought (upper half)";
+    if (close < middle) return "Slightly Oversold (lower half)";
+    return "NEUTRAL (at fair value)";
+}
+
+const char* HurstBehavior(double hurst) {
+    if (std::isnan(hurst)) return "";
+    if (hurst > 0.55) return "TRENDING/PERSISTENT";
+    if (hurst < 0.45) return "MEAN-REVERTING";
+    return "RANDOM WALK";
+}
+
+void WriteAnalysisJson(JsonWriter& json, const TickerAnalysis& analysis, bool includeSeries) {
+    const PriceSeries& data = analysis.load.series;
+    const IndicatorResults& ind = analysis.indicators;
+    json.BeginObject();
+    json.Key("ticker").String(analysis.ticker);
+    json.Key("source").String(analysis.load.source);
+    json.Key("rows").Int(static_cast<long long>(data.size()));
+    if (data.empty()) {
+        json.EndObject();
+        return;
+    }
+
+    const size_t last = data.size() - 1;
+    const double close = data.Close()[last];
+    auto at = [last](const std::vector<double>& v) {
+        return last < v.size() ? v[last] : std::numeric_limits<double>::quiet_NaN();
+    };
+    auto lag = [&](size_t k) {
+        const std::vector<double>& acf = ind.autocorrelation.acf;
+        return k <= acf.size() ? acf[k - 1] : std::numeric_limits<double>::quiet_NaN();
+    };
+
+    json.Key("latestDate").String(FormatDate(data.Date(last)));
+    json.Key("latestClose").Number(close);
+    json.Key("sma20").Number(at(ind.sma));
+    json.Key("volatility20").Number(at(ind.volatility));
+    json.Key("returns").BeginObject()
+        .Key("mean").Number(ind.stats.mean)
+        .Key("stddev").Number(ind.stats.stddev)
+        .Key("max").Number(ind.stats.max)
+        .Key("min").Number(ind.stats.min)
+        .EndObject();
+    json.Key("sharpe").Number(ind.sharpe);
+    json.Key("periodReturn").Number(ind.periodReturn);
+    json.Key("maxDrawdown").Number(ind.maxDrawdown);
+
+    const double middle = at(ind.bollingerMiddle);
+    const double upper = at(ind.bollingerUpper);
+    const double lower = at(ind.bollingerLower);
+    json.Key("bollinger").BeginObject()
+        .Key("middle").Number(middle)
+        .Key("upper").Number(upper)
+        .Key("lower").Number(lower)
+        .Key("status").String(BollingerStatus(close, middle, upper, lower))
+        .EndObject();
+    json.Key("trendUp").Bool(close > at(ind.sma));
+    json.Key("acf").BeginObject()
+        .Key("lag1").Number(lag(1))
+        .Key("lag5").Number(lag(5))
+        .Key("lag20").Number(lag(20))
+        .EndObject();
+    json.Key("acfLags").BeginArray();
+    for (double value : ind.autocorrelation.acf) json.Number(value);
+    json.EndArray();
+    json.Key("hurst").Number(ind.hurst);
+    json.Key("hurstBehavior").String(HurstBehavior(ind.hurst));
+
+    json.Key("strategies").BeginArray();
+    for (const StrategyPerformance& perf : analysis.evaluation.ranking) {
+        json.BeginObject()
+            .Key("name").String(perf.strategyName)
+            .Key("totalReturn").Number(perf.totalReturn)
+            .Key("sharpe").Number(perf.sharpeRatio)
+            .Key("maxDrawdown").Number(perf.maxDrawdown)
+            .Key("winRate").Number(perf.winRate)
+            .Key("score").Number(perf.score)
+            .EndObject();
+    }
+    json.EndArray();
+    json.Key("recommended").String(analysis.evaluation.best ? analysis.evaluation.bestPerformance.strategyName : "");
+    json.Key("signal").Number(analysis.signal);
+    json.Key("action").String(std::isnan(analysis.signal) ? "" : SignalAction(analysis.signal));
+
+    if (includeSeries) {
+        // Columnar, one array per indicator, so a reader can hand the object
+        // straight to a data frame
+        auto column = [&](const char* name, const std::vector<double>& values) {
+            json.Key(name).BeginArray();
+            for (size_t i = 0; i < data.size(); ++i) {
+                json.Number(i < values.size() ? values[i] : std::numeric_limits<double>::quiet_NaN());
+            }
+            json.EndArray();
+        };
+        json.Key("series").BeginObject();
+        json.Key("date").BeginArray();
+        char date[10];
+        for (size_t i = 0; i < data.size(); ++i) {
+            FormatDate(data.Date(i), date);
+            json.String(std::string_view(date, sizeof(date)));
+        }
+        json.EndArray();
+        json.Key("close").BeginArray();
+        for (double value : data.Close()) json.Number(value);
+        json.EndArray();
+        json.Key("volume").BeginArray();
+        for (double value : data.Volume()) json.Number(value);
+        json.EndArray();
+        column("return", ind.returns);
+        column("sma20", ind.sma);
+        column("volatility20", ind.volatility);
+        column("bollingerMiddle", ind.bollingerMiddle);
+        column("bollingerUpper", ind.bollingerUpper);
+        column("bollingerLower", ind.bollingerLower);
+        json.EndObject();
+    }
+    json.EndObject();
+}
+
+size_t AnalysisJsonSizeHint(const TickerAnalysis& analysis, bool includeSeries) {
+    // About 2 KB of summary, plus 9 columns of up to ~24 characters per bar
+    return 2048 + (includeSeries ? analysis.load.series.size() * 240 : 0);
+}
+
+std::string AnalysisJson(const TickerAnalysis& analysis, bool includeSeries) {
+    JsonWriter json;
+    json.Reserve(AnalysisJsonSizeHint(analysis, includeSeries));
+    WriteAnalysisJson(json, analysis, includeSeries);
+    return json.Take();
+}
+
+std::string TickerName(const std::string& key) {
+    fs::path path(key);
+    if (path.extension() == ".csv") return path.stem().string();
+    return key;
+}
+
+std::vector<std::string> ResolveUniverse(const std::string& spec, std::string& error) {
+    std::vector<std::string> keys;
+    std::error_code ec;
+
+    if (fs::is_directory(spec, ec)) {
+        for (const auto& entry : fs::directory_iterator(spec, ec)) {
+            if (entry.is_regular_file(ec) && entry.path().extension() == ".csv") {
+                keys.push_back(entry.path().string());
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        if (keys.empty()) error = "no .csv files in " + spec;
+        return keys;
+    }
+
+    if (fs::is_regular_file(spec, ec)) {
+        std::ifstream in(spec);
+        std::string line;
+        while (std::getline(in, line)) {
+            line = Trim(line.substr(0, line.find('#')));
+            if (!line.empty()) keys.push_back(line);
+        }
+        if (keys.empty()) error = "no tickers listed in " + spec;
+        return keys;
+    }
+
+    std::stringstream list(spec);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        item = Trim(item);
+        if (!item.empty()) keys.push_back(item);
+    }
+    if (keys.empty()) error = "no tickers in '" + spec + "'";
+    return keys;
+}
+
+void RunUniverse(const std::vector<std::string>& keys,
+                 const std::function<void(TickerAnalysis&)>& onResult,
+                 ThreadPool& pool) {
+    StockDataLoader loader;
+
+    // Drop duplicates (keeping the first occurrence), then order by the size
+    // of the local CSV so the longest histories are picked up first. Tickers
+    // that will be downloaded have no size yet and go last.
+    std::vector<std::string> unique;
+    std::set<std::string> seen;
+    for (const auto& key : keys) {
+        if (seen.insert(key).second) unique.push_back(key);
+    }
+
+    std::vector<std::uintmax_t> sizes(unique.size(), 0);
+    for (size_t i = 0; i < unique.size(); ++i) {
+        std::string path = loader.FindTickerCSV(unique[i]);
+        std::error_code ec;
+        if (!path.empty()) {
+            std::uintmax_t size = fs::file_size(path, ec);
+            if (!ec) sizes[i] = size;
+        }
+    }
+    std::vector<size_t> order(unique.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    std::mutex reportMutex;
+    bool reportFailed = false;   // onResult threw: stop reporting
+    std::vector<std::future<void>> pending;
+    pending.reserve(order.size());
+    for (size_t i : order) {
+        const std::string& key = unique[i];
+        pending.push_back(pool.Submit([&, key] {
+            TickerAnalysis analysis;
+            try {
+                analysis = AnalyzeTicker(loader, key);
+            } catch (const std::exception& e) {
+                analysis.ticker = TickerName(key);
+                analysis.signal = std::numeric_limits<double>::quiet_NaN();
+                analysis.elapsedMs = 0.0;
+                analysis.load.status = LoadStatus::ParseError;
+                analysis.load.error = e.what();
+            }
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if (reportFailed) return;
+            try {
+                onResult(analysis);
+            } catch (...) {
+                reportFailed = true;
+                throw;
+            }
+        }));
+    }
+
+    // Every task references this frame, so wait for all of them before
+    // leaving, even when one has failed; then rethrow the first failure
+    std::exception_ptr firstError;
+    for (auto& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+    if (firstError) std::rethrow_exception(firstError);
+}
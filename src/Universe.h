@@ -0,0 +1,82 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AnalysisStrategy.h"
+#include "IndicatorPipeline.h"
+#include "StockDataLoader.h"
+#include "StrategySelector.h"
+#include "ThreadPool.h"
+
+class JsonWriter;
+
+// Everything the stocks binary reports for one ticker
+struct TickerAnalysis {
+    std::string ticker;
+    TickerLoadResult load;          // series plus where it came from
+    IndicatorResults indicators;    // default IndicatorSpec (20-day windows, 20 ACF lags)
+    std::vector<std::unique_ptr<AnalysisStrategy>> strategies;
+    StrategyEvaluation evaluation;  // evaluation.best points into strategies
+    double signal;                  // best strategy's signal on the latest bar (NaN if none)
+    double elapsedMs;               // wall time spent in AnalyzeTicker / AnalyzeSeries
+};
+
+// The candidate strategies main.cpp compares: trending, mean reversion, buy & hold
+std::vector<std::unique_ptr<AnalysisStrategy>> DefaultStrategies();
+
+// Indicators, strategy selection and the current signal for an already
+// loaded series. load.series is set to data and load.status to Ok.
+TickerAnalysis AnalyzeSeries(const std::string& ticker, const PriceSeries& data);
+
+// Quietly load ticker (see StockDataLoader::LoadTicker) and analyze it. When
+// loading fails only ticker, load and elapsedMs are meaningful.
+TickerAnalysis AnalyzeTicker(StockDataLoader& loader, const std::string& ticker,
+                             bool allowFetch = true);
+
+// Action label for a strategy signal, using the thresholds main.cpp prints
+// ("STRONG BUY" above 10, "BUY" above 5, ...)
+const char* SignalAction(double signal);
+
+// Bollinger position label main.cpp prints for the latest close
+// ("OVERBOUGHT", "Slightly Oversold (lower half)", ...)
+const char* BollingerStatus(double close, double middle, double upper, double lower);
+
+// Hurst behavior label main.cpp prints ("TRENDING/PERSISTENT",
+// "MEAN-REVERTING", "RANDOM WALK"; "" when the exponent is NaN)
+const char* HurstBehavior(double hurst);
+
+// The single-ticker report as one JSON object: latest bar, summary
+// indicators, Bollinger position, ACF lags 1/5/20 and the whole spectrum,
+// Hurst, the ranked strategy backtests and the recommendation. With
+// includeSeries a "series" object adds one array per bar column (date,
+// close, volume, return, sma20, volatility20, Bollinger middle/upper/lower).
+// NaN values become null.
+std::string AnalysisJson(const TickerAnalysis& analysis, bool includeSeries = false);
+
+// AnalysisJson into an existing writer (e.g. one buffer for many tickers)
+void WriteAnalysisJson(JsonWriter& json, const TickerAnalysis& analysis, bool includeSeries = false);
+
+// Upper estimate of AnalysisJson's length, for JsonWriter::Reserve
+size_t AnalysisJsonSizeHint(const TickerAnalysis& analysis, bool includeSeries = false);
+
+// Expand a --universe argument into load keys for AnalyzeTicker:
+// - a directory: every *.csv in it (as paths, sorted)
+// - a file: one ticker or CSV path per line; blank lines and '#' comments skipped
+// - anything else: a comma-separated ticker list
+// Returns an empty list and sets error when nothing usable is found.
+std::vector<std::string> ResolveUniverse(const std::string& spec, std::string& error);
+
+// Display name for a load key: "data/NVDA.csv" -> "NVDA", "AAPL" -> "AAPL"
+std::string TickerName(const std::string& key);
+
+// Load and analyze every ticker as its own task on pool. Tasks are submitted
+// largest local CSV first, so long histories start early instead of
+// straggling at the end; idle workers steal whatever is left. onResult runs
+// once per ticker as soon as it finishes (calls are serialized, in completion
+// order). Returns when every ticker has been reported. If onResult throws,
+// it is not called again; the remaining tasks finish and the exception is
+// rethrown once none is running.
+void RunUniverse(const std::vector<std::string>& keys,
+                 const std::function<void(TickerAnalysis&)>& onResult,
+                 ThreadPool& pool = SharedThreadPool());
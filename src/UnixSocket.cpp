@@ -0,0 +1,77 @@
+#include "UnixSocket.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+int ListenUnixSocket(const std::string& path, std::string& error) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        error = "socket path must be 1-" + std::to_string(sizeof(addr.sun_path) - 1) + " characters";
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return -1;
+    }
+
+    // Only a stale socket may be replaced; anything else at the path (a
+    // regular file, a directory, a symlink) is left alone
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            ::close(listener);
+            error = path + " exists and is not a socket";
+            return -1;
+        }
+        if (::connect(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            ::close(listener);
+            error = "a server is already listening on " + path;
+            return -1;
+        }
+        ::close(listener);
+        ::unlink(path.c_str());
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            error = std::string("socket: ") + std::strerror(errno);
+            return -1;
+        }
+    }
+
+    // Create the socket file owner-only from the start, so no other user can
+    // connect before it is locked down
+    mode_t previousMask = ::umask(0077);
+    int bound = ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    int bindErrno = errno;
+    ::umask(previousMask);
+    if (bound != 0 || ::listen(listener, 64) != 0) {
+        error = "cannot listen on " + path + ": " + std::strerror(bound != 0 ? bindErrno : errno);
+        ::close(listener);
+        return -1;
+    }
+    ::chmod(path.c_str(), 0600);
+    return listener;
+}
+
+void RemoveUnixSocket(const std::string& path) {
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) ::unlink(path.c_str());
+}
+
+bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        // MSG_NOSIGNAL: a client that hung up must not SIGPIPE the daemon
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
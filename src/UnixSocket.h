@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+
+// Listening Unix domain socket at path, owner-only (0600), for the local
+// daemons (--serve, --stream). A socket file left behind by a crashed process
+// is replaced, but one a live process still answers on is left alone, and a
+// path that is not a socket is never touched. Returns the listening
+// descriptor, or -1 with error set.
+int ListenUnixSocket(const std::string& path, std::string& error);
+
+// Remove the socket file at path on shutdown; does nothing if path is no
+// longer a socket
+void RemoveUnixSocket(const std::string& path);
+
+// Write all of data to a connected socket, retrying after EINTR. Never raises
+// SIGPIPE; returns false once the peer is gone.
+bool SendAll(int fd, const std::string& data);
@@ -0,0 +1,93 @@
+#include "WalkForward.h"
+#include "BacktestKernel.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+
+WalkForwardReport WalkForward::Run(const WalkForwardSpec& spec) const {
+    const PrefixIndicators& ind = indicators_;
+    const size_t n = ind.size();
+
+    WalkForwardReport report;
+    report.stitched = MakePerformance("Walk-forward (out of sample)", { 0.0, 0.0, 0.0, 0.0, 0.0, 0 });
+
+    std::vector<GridPoint> points = GridPoints(spec.grid, spec.trainBars);
+    if (spec.trainBars <= 0 || spec.testBars <= 0 || points.empty()) {
+        return report;
+    }
+
+    // Folds advance by testBars; the last position of a test window is held
+    // to the next close, so every window must end before the final bar
+    const size_t train = spec.trainBars;
+    const size_t test = spec.testBars;
+    for (size_t begin = 0; begin + train + test < n; begin += test) {
+        WalkForwardFold fold;
+        fold.trainBegin = begin;
+        fold.trainEnd = fold.testBegin = begin + train;
+        fold.testEnd = begin + train + test;
+        report.folds.push_back(fold);
+    }
+    if (report.folds.empty()) {
+        return report;
+    }
+
+    // Folds are evaluated in blocks spanning about kBlockBars bars of test
+    // windows. Each block stores every grid point's position (a -1/0/+1
+    // direction code) for the bars its folds cover, computed once and shared
+    // by those folds, so memory is points x (trainBars + kBlockBars) bytes
+    // however long the history is; only a block's leading train window is
+    // computed again for the next block.
+    constexpr size_t kBlockBars = 8192;
+    const size_t foldsPerBlock = std::max<size_t>(1, kBlockBars / test);
+    const size_t last = report.folds.back().testEnd;
+    const size_t firstTest = report.folds.front().testBegin;
+    std::vector<int8_t> positions;
+    std::vector<int8_t> stitchedPositions(last - firstTest);  // each test window with its fold's choice
+
+    auto backtestCodes = [&](const int8_t* codes, size_t begin, size_t end) {
+        const PriceColumn close(ind.Close().data() + begin, end - begin + 1);
+        return RunBacktestWith(close, [codes](size_t i) { return static_cast<double>(codes[i]); });
+    };
+
+    for (size_t blockBegin = 0; blockBegin < report.folds.size(); blockBegin += foldsPerBlock) {
+        const size_t blockEnd = std::min(report.folds.size(), blockBegin + foldsPerBlock);
+        const size_t origin = report.folds[blockBegin].trainBegin;
+        const size_t width = report.folds[blockEnd - 1].testEnd - origin;
+
+        // Row p holds point p for bars [origin, origin + width)
+        positions.resize(points.size() * width);
+        ParallelFor(points.size(), [&](size_t p) {
+            int8_t* row = positions.data() + p * width;
+            for (size_t i = 0; i < width; ++i) {
+                row[i] = static_cast<int8_t>(GridPosition(ind, points[p], origin + i, 0));
+            }
+        });
+        auto row = [&](size_t p, size_t bar) { return positions.data() + p * width + (bar - origin); };
+
+        ParallelFor(blockEnd - blockBegin, [&](size_t k) {
+            WalkForwardFold& fold = report.folds[blockBegin + k];
+            size_t bestPoint = 0;
+            for (size_t p = 0; p < points.size(); ++p) {
+                const GridPoint& point = points[p];
+                std::string name = GridStrategyName(point.strategy);
+                GridResult candidate = { name, point.window, point.threshold, point.lookback,
+                                         MakePerformance(name, backtestCodes(row(p, fold.trainBegin),
+                                                                             fold.trainBegin, fold.trainEnd)) };
+                if (p == 0 || BetterGridResult(candidate, fold.best)) {
+                    fold.best = candidate;
+                    bestPoint = p;
+                }
+            }
+            const int8_t* chosen = row(bestPoint, fold.testBegin);
+            fold.outOfSample = MakePerformance(fold.best.strategy,
+                                               backtestCodes(chosen, fold.testBegin, fold.testEnd));
+            std::copy(chosen, chosen + (fold.testEnd - fold.testBegin),
+                      stitchedPositions.begin() + (fold.testBegin - firstTest));
+        });
+    }
+
+    // Chain the test windows, each with its own fold's chosen positions
+    report.stitched = MakePerformance(report.stitched.strategyName,
+                                      backtestCodes(stitchedPositions.data(), firstTest, last));
+    return report;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "GridSearch.h"
+
+// Fold layout and parameter grid for a walk-forward run
+struct WalkForwardSpec {
+    int trainBars = 250;   // bars the parameters are chosen on
+    int testBars = 50;     // following bars they are then traded on; folds advance by this much
+    GridSearchSpec grid;   // candidates (lookbacks are ignored; the train window is the lookback)
+};
+
+// One train/test split. Positions are taken at the close of bars
+// [begin, end) and held to the next close, so a window of k bars covers k
+// returns and test windows of consecutive folds tile the history.
+struct WalkForwardFold {
+    size_t trainBegin;
+    size_t trainEnd;                 // == testBegin
+    size_t testBegin;
+    size_t testEnd;
+    GridResult best;                 // chosen on the train window (in-sample performance)
+    StrategyPerformance outOfSample; // the same parameters on the test window
+};
+
+struct WalkForwardReport {
+    std::vector<WalkForwardFold> folds;
+    // All test windows chained together, each traded with its own fold's
+    // parameters; zero-filled when there are no folds
+    StrategyPerformance stitched;
+};
+
+// Walk-forward optimization: slide train/test windows across the whole
+// history, pick the best grid point on each train window and trade it on the
+// following test window.
+//
+// Indicators come from one PrefixIndicators over the full series (history
+// before a window is visible, as it would be live). Folds run in blocks: a
+// block stores each grid point's positions for the bars its folds cover as
+// one byte per bar, shared by all of those folds, so memory stays bounded on
+// arbitrarily long histories. A fold then only runs the allocation-free
+// backtest kernel over stored positions. Folds within a block are evaluated
+// in parallel.
+class WalkForward {
+public:
+    explicit WalkForward(const PriceSeries& data) : indicators_(data) {}
+
+    WalkForwardReport Run(const WalkForwardSpec& spec = WalkForwardSpec()) const;
+
+private:
+    PrefixIndicators indicators_;
+};
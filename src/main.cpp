@@ -1,51 +1,599 @@
 #include "StockDataLoader.h"
-#include "StockAnalytics.h"
+#include "IndicatorPipeline.h"
 #include "StrategySelector.h"
-#include "TrendingStrategy.h"
-#include "MeanReversionStrategy.h"
-#include "BuyAndHoldStrategy.h"
+#include "GridSearch.h"
+#include "WalkForward.h"
+#include "Universe.h"
+#include "Portfolio.h"
+#include "AnalysisServer.h"
+#include "ReportFormat.h"
+#include "StreamEngine.h"
+#include "ReplayEngine.h"
+#include "JsonWriter.h"
+#include "TradingDate.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <memory>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 
-int main(int argc, char* argv[]) {
-    StockDataLoader loader;
-    StockAnalytics analytics;
+namespace {
 
-    // Accept ticker from command line, default to AAPL if not provided
+// Analyze one ticker (default AAPL) and print the full report.
+// --grid additionally prints a parameter sweep of the strategies,
+// --walkforward an out-of-sample walk-forward evaluation of that sweep.
+// --universe <dir|file|A,B,C> analyzes many tickers at once and prints
+// one summary line per ticker instead of the full report.
+// --portfolio <dir|file|A,B,C> backtests the strategies across those
+// tickers as one rebalanced portfolio.
+// --serve keeps analyses resident and answers requests on a Unix socket
+// (stocks.sock, or --socket <path>) until interrupted.
+// --format=json|bin writes the single-ticker or universe reports as JSON
+// lines or binary records (see ReportFormat.h) instead of text; --series
+// adds the full per-bar indicator columns to them.
+// --stream reads bars from stdin (or, with --socket <path>, from any
+// number of producers on a Unix socket) and prints each signal zone
+// change as it happens, as text or (--format=json) JSON lines; see
+// StreamEngine.h for the protocol and replay_bars.py for a feed.
+// --replay merges the --universe tickers (default: the CSVs here) and/or
+// --synthetic <n> generated series of --bars <m> days into one stream,
+// replays it through the streaming engine as fast as possible or at
+// --speed <market seconds per second>, and reports end-to-end latency
+// percentiles and bars/sec (--lines uses the line protocol, --seed <s>
+// varies the synthetic data). See ReplayEngine.h.
+const char kUsage[] =
+    "usage: stocks [TICKER] [--grid] [--walkforward] [--format=text|json|bin] [--series]\n"
+    "       stocks --universe <dir|file|A,B,C> [--format=text|json|bin] [--series]\n"
+    "       stocks --portfolio <dir|file|A,B,C>\n"
+    "       stocks --serve [--socket <path>]\n"
+    "       stocks --stream [--socket <path>] [--format=text|json]\n"
+    "       stocks --replay [--universe <dir|file|A,B,C>] [--synthetic <n>] [--bars <m>]\n"
+    "                       [--seed <s>] [--speed <x>] [--lines] [--format=text|json]\n";
+
+struct Options {
     std::string ticker = "AAPL";
-    if (argc > 1) {
-        ticker = argv[1];
+    std::string universe;
+    std::string portfolio;
+    std::string socketPath = "stocks.sock";
+    bool socketGiven = false;
+    bool serve = false;
+    bool stream = false;
+    bool replay = false;
+    bool help = false;
+    size_t syntheticTickers = 0;
+    size_t syntheticBars = 2520;
+    uint64_t seed = 1;
+    ReplayOptions replayOptions;
+    bool runGrid = false;
+    bool runWalkForward = false;
+    OutputFormat format = OutputFormat::Text;
+    bool includeSeries = false;
+};
+
+// Fill options from the command line. Unknown options, options missing
+// their value and malformed numbers are errors rather than being taken
+// for a ticker.
+bool ParseOptions(int argc, char* argv[], Options& options, std::string& error) {
+    bool tickerGiven = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc || std::string(argv[i + 1]).rfind("--", 0) == 0) {
+                error = arg + " needs a value";
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+        auto count = [&](uint64_t& out) {
+            std::string text;
+            if (!value(text)) return false;
+            auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+                error = arg + " expects a non-negative integer, got '" + text + "'";
+                return false;
+            }
+            return true;
+        };
+
+        if (arg.rfind("--format=", 0) == 0 || arg == "--format") {
+            std::string name = arg.substr(std::min<size_t>(arg.size(), 9));
+            if (arg == "--format" && !value(name)) return false;
+            if (!ParseOutputFormat(name, options.format)) {
+                error = "Unknown format '" + name + "' (expected text, json or bin)";
+                return false;
+            }
+        } else if (arg == "--series") {
+            options.includeSeries = true;
+        } else if (arg == "--grid") {
+            options.runGrid = true;
+        } else if (arg == "--walkforward") {
+            options.runWalkForward = true;
+        } else if (arg == "--universe") {
+            if (!value(options.universe)) return false;
+        } else if (arg == "--portfolio") {
+            if (!value(options.portfolio)) return false;
+        } else if (arg == "--serve") {
+            options.serve = true;
+        } else if (arg == "--stream") {
+            options.stream = true;
+        } else if (arg == "--replay") {
+            options.replay = true;
+        } else if (arg == "--synthetic") {
+            uint64_t n = 0;
+            if (!count(n)) return false;
+            options.syntheticTickers = static_cast<size_t>(n);
+        } else if (arg == "--bars") {
+            uint64_t n = 0;
+            if (!count(n)) return false;
+            options.syntheticBars = static_cast<size_t>(n);
+        } else if (arg == "--seed") {
+            if (!count(options.seed)) return false;
+        } else if (arg == "--speed") {
+            std::string text;
+            if (!value(text)) return false;
+            char* end = nullptr;
+            options.replayOptions.speed = std::strtod(text.c_str(), &end);
+            if (text.empty() || *end != '\0' || !(options.replayOptions.speed >= 0.0)) {
+                error = "--speed expects a non-negative number, got '" + text + "'";
+                return false;
+            }
+        } else if (arg == "--lines") {
+            options.replayOptions.lineProtocol = true;
+        } else if (arg == "--socket") {
+            if (!value(options.socketPath)) return false;
+            options.socketGiven = true;
+        } else if (arg == "--help" || arg == "-h") {
+            options.help = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            error = "Unknown option '" + arg + "'";
+            return false;
+        } else if (tickerGiven) {
+            error = "Only one ticker can be given ('" + options.ticker + "' and '" + arg + "')";
+            return false;
+        } else {
+            options.ticker = arg;
+            tickerGiven = true;
+        }
     }
-    
-    auto data = loader.LoadByTicker(ticker);
-    std::cout << "Loaded " << data.size() << " rows for " << ticker << ".\n";
+    return true;
+}
 
-    if (data.empty()) {
+int ServeMode(const Options& options) {
+    AnalysisServer server(options.socketPath);
+    std::cout << "Serving analyses on " << options.socketPath << " (Ctrl-C to stop)\n";
+    std::cout.flush();
+    int status = server.Run();
+    if (status != 0) std::cout << "Server error: " << server.error() << "\n";
+    return status;
+}
+
+// ============================================================
+// STREAMING
+// ============================================================
+int StreamMode(const Options& options) {
+    if (options.format == OutputFormat::Binary) {
+        std::cerr << "--stream reports events as text or json\n";
+        return 1;
+    }
+
+    // Events are written (and flushed) one at a time so a consumer sees
+    // each crossing as soon as the bar that caused it is processed
+    std::string line;
+    StreamEngine engine([&](const SignalEvent& e) {
+        line.clear();
+        if (options.format == OutputFormat::Json) {
+            JsonWriter json(std::move(line));
+            json.BeginObject()
+                .Key("ticker").String(e.ticker)
+                .Key("date").String(FormatDate(e.date))
+                .Key("strategy").String(e.strategy)
+                .Key("from").String(e.from)
+                .Key("to").String(e.to)
+                .Key("signal").Number(e.signal)
+                .Key("close").Number(e.close)
+                .Key("latencyUs").Number(e.latencyUs)
+                .EndObject();
+            line = json.Take();
+            line += '\n';
+        } else {
+            char buf[256];
+            std::snprintf(buf, sizeof(buf), "%s %-6s %-26s %s -> %s (signal %.2f, close %.2f, %.1f us)\n",
+                          FormatDate(e.date).c_str(), e.ticker.c_str(), e.strategy, e.from, e.to,
+                          e.signal, e.close, e.latencyUs);
+            line = buf;
+        }
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        std::fflush(stdout);
+    });
+    auto onError = [](const std::string& message) { std::cerr << "Skipped " << message << "\n"; };
+
+    if (options.socketGiven) {
+        std::cerr << "Streaming bars from " << options.socketPath << " (Ctrl-C to stop)\n";
+        std::string error;
+        if (ServeStream(engine, options.socketPath, error, onError) != 0) {
+            std::cerr << "Stream error: " << error << "\n";
+            return 1;
+        }
+    } else {
+        RunStream(engine, 0, onError);
+    }
+
+    StreamStats stats = engine.Stats();
+    std::cerr << "Stream: " << stats.bars << " bars, " << stats.tickers << " tickers, "
+              << stats.rejected << " rejected, " << stats.events << " events\n"
+              << std::fixed << std::setprecision(1)
+              << "Latency (us): p50 " << stats.latencyP50Us << ", p99 " << stats.latencyP99Us
+              << ", max " << stats.latencyMaxUs << ", mean " << stats.latencyMeanUs << "\n";
+    return 0;
+}
+
+// ============================================================
+// REPLAY LOAD TEST
+// ============================================================
+int ReplayMode(const Options& options) {
+    StockDataLoader loader;
+    if (options.format == OutputFormat::Binary) {
+        std::cerr << "--replay reports as text or json\n";
+        return 1;
+    }
+
+    std::vector<ReplaySource> sources;
+    if (!options.universe.empty() || options.syntheticTickers == 0) {
+        std::string error;
+        std::vector<std::string> keys = ResolveUniverse(options.universe.empty() ? "." : options.universe, error);
+        if (keys.empty()) {
+            std::cerr << "Replay error: " << error << "\n";
+            return 1;
+        }
+        std::map<std::string, TickerLoadResult> loaded = loader.LoadByTickers(keys, false);
+        for (const auto& key : keys) {
+            const TickerLoadResult& load = loaded[key];
+            if (load.status != LoadStatus::Ok || load.series.empty()) {
+                std::cerr << "Skipping " << key << ": "
+                          << (load.error.empty() ? std::string("no data") : load.error) << "\n";
+                continue;
+            }
+            sources.push_back({ TickerName(key), load.series });
+        }
+    }
+    std::vector<ReplaySource> synthetic = SyntheticSources(options.syntheticTickers, options.syntheticBars, options.seed);
+    sources.insert(sources.end(), synthetic.begin(), synthetic.end());
+
+    // Events are only counted: printing them would measure the terminal
+    StreamEngine engine(nullptr);
+    ReplayReport r = RunReplay(sources, options.replayOptions, engine);
+    if (!r.error.empty()) {
+        std::cerr << "Replay error: " << r.error << "\n";
+        return 1;
+    }
+
+    if (options.format == OutputFormat::Json) {
+        auto latency = [](JsonWriter& json, const char* key, const LatencySummary& l) {
+            json.Key(key).BeginObject()
+                .Key("p50").Number(l.p50).Key("p90").Number(l.p90)
+                .Key("p99").Number(l.p99).Key("p999").Number(l.p999)
+                .Key("max").Number(l.max).Key("mean").Number(l.mean)
+                .EndObject();
+        };
+        JsonWriter json;
+        json.BeginObject()
+            .Key("bars").Int(static_cast<long long>(r.bars))
+            .Key("tickers").Int(static_cast<long long>(r.tickers))
+            .Key("days").Int(static_cast<long long>(r.days))
+            .Key("protocol").String(options.replayOptions.lineProtocol ? "line" : "binary")
+            .Key("speed").Number(options.replayOptions.speed)
+            .Key("wallSeconds").Number(r.wallSeconds)
+            .Key("barsPerSecond").Number(r.barsPerSecond)
+            .Key("rejected").Int(static_cast<long long>(r.engine.rejected))
+            .Key("events").Int(static_cast<long long>(r.engine.events));
+        latency(json, "endToEndUs", r.endToEndUs);
+        json.Key("engineUs").BeginObject()
+            .Key("p50").Number(r.engine.latencyP50Us).Key("p99").Number(r.engine.latencyP99Us)
+            .Key("max").Number(r.engine.latencyMaxUs).Key("mean").Number(r.engine.latencyMeanUs)
+            .EndObject();
+        json.EndObject();
+        std::cout << json.str() << "\n";
+        return 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "REPLAY LOAD TEST\n";
+    std::cout << std::string(60, '=') << "\n";
+    std::cout << "Bars: " << r.bars << " (" << r.tickers << " tickers, " << r.days << " days, "
+              << (options.replayOptions.lineProtocol ? "line" : "binary") << " protocol)\n";
+    if (options.replayOptions.speed > 0.0) {
+        std::cout << "Speed: " << options.replayOptions.speed << "x market time\n";
+    } else {
+        std::cout << "Speed: as fast as possible\n";
+    }
+    std::cout << "Wall time: " << std::setprecision(3) << r.wallSeconds << " s\n";
+    std::cout << "Throughput: " << std::setprecision(0) << r.barsPerSecond << " bars/sec\n";
+    std::cout << "Rejected: " << r.engine.rejected << "  Signal events: " << r.engine.events << "\n";
+    std::cout << std::setprecision(1);
+    std::cout << "End-to-end latency (us): p50 " << r.endToEndUs.p50 << "  p90 " << r.endToEndUs.p90
+              << "  p99 " << r.endToEndUs.p99 << "  p99.9 " << r.endToEndUs.p999
+              << "  max " << r.endToEndUs.max << "  mean " << r.endToEndUs.mean << "\n";
+    std::cout << "Engine latency (us):     p50 " << r.engine.latencyP50Us << "  p99 "
+              << r.engine.latencyP99Us << "  max " << r.engine.latencyMaxUs << "  mean "
+              << r.engine.latencyMeanUs << "\n";
+    return 0;
+}
+
+// ============================================================
+// MACHINE-READABLE OUTPUT
+// ============================================================
+int MachineReadableMode(const Options& options) {
+    StockDataLoader loader;
+    if (!options.portfolio.empty() || options.runGrid || options.runWalkForward) {
+        std::cerr << "--portfolio, --grid and --walkforward are only reported as text\n";
+        return 1;
+    }
+
+    // One buffer for the whole run; each report is serialized into it
+    // and written with a single fwrite, then the buffer is reused
+    std::string out;
+    size_t done = 0;
+    size_t failed = 0;
+    auto emit = [&](const TickerAnalysis& a) {
+        ++done;
+        if (a.load.status != LoadStatus::Ok || a.load.series.empty()) ++failed;
+        out.clear();
+        AppendAnalysis(a, options.format, options.includeSeries, out);
+        std::fwrite(out.data(), 1, out.size(), stdout);
+    };
+
+    if (options.universe.empty()) {
+        emit(AnalyzeTicker(loader, options.ticker));
+        std::fflush(stdout);
+        return failed == 0 ? 0 : 1;
+    }
+
+    std::string error;
+    std::vector<std::string> keys = ResolveUniverse(options.universe, error);
+    if (keys.empty()) {
+        std::cerr << "Universe error: " << error << "\n";
+        return 1;
+    }
+    RunUniverse(keys, [&](TickerAnalysis& a) {
+        emit(a);
+        std::fflush(stdout);
+    });
+    return failed == done ? 1 : 0;
+}
+
+// ============================================================
+// UNIVERSE BATCH MODE
+// ============================================================
+int UniverseMode(const Options& options) {
+    std::string error;
+    std::vector<std::string> keys = ResolveUniverse(options.universe, error);
+    if (keys.empty()) {
+        std::cout << "Universe error: " << error << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0;
+    size_t failed = 0;
+    std::cout << std::fixed;
+    RunUniverse(keys, [&](TickerAnalysis& a) {
+        ++done;
+        std::cout << "[" << std::setw(4) << done << "/" << keys.size() << "] "
+                  << std::left << std::setw(8) << a.ticker << std::right;
+        if (a.load.status != LoadStatus::Ok || a.load.series.empty()) {
+            ++failed;
+            std::cout << " failed: "
+                      << (a.load.error.empty() ? std::string("no data") : a.load.error) << "\n";
+            return;
+        }
+        const IndicatorResults& ind = a.indicators;
+        const size_t lastIdx = a.load.series.size() - 1;
+        std::cout << std::setprecision(2)
+                  << " rows " << std::setw(6) << a.load.series.size()
+                  << "  close " << std::setw(9) << a.load.series.Close()[lastIdx]
+                  << std::setprecision(4)
+                  << "  vol20 " << ind.volatility[lastIdx]
+                  << "  sharpe " << std::setw(7) << ind.sharpe
+                  << std::setprecision(1)
+                  << "  maxDD " << std::setw(6) << ind.maxDrawdown * 100.0 << "%"
+                  << std::setprecision(2)
+                  << "  hurst " << ind.hurst
+                  << "  best " << std::left << std::setw(28) << a.evaluation.bestPerformance.strategyName
+                  << std::right << " signal " << std::setw(7) << a.signal
+                  << "  " << std::left << std::setw(14) << SignalAction(a.signal) << std::right
+                  << std::setprecision(0) << " (" << a.elapsedMs << " ms)\n";
+        std::cout.flush();
+    });
+    double totalMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setprecision(0) << "\nAnalyzed " << done << " tickers (" << failed
+              << " failed) in " << totalMs << " ms\n";
+    return failed == done ? 1 : 0;
+}
+
+// ============================================================
+// PORTFOLIO BACKTEST
+// ============================================================
+int PortfolioMode(const Options& options) {
+    StockDataLoader loader;
+    std::string error;
+    std::vector<std::string> keys = ResolveUniverse(options.portfolio, error);
+    if (keys.empty()) {
+        std::cout << "Portfolio error: " << error << "\n";
+        return 1;
+    }
+
+    std::map<std::string, TickerLoadResult> loaded = loader.LoadByTickers(keys);
+    std::vector<std::string> names;
+    std::vector<PriceSeries> series;
+    for (const auto& key : keys) {
+        const TickerLoadResult& load = loaded[key];
+        if (load.status != LoadStatus::Ok || load.series.empty()) {
+            std::cout << "Skipping " << key << ": "
+                      << (load.error.empty() ? std::string("no data") : load.error) << "\n";
+            continue;
+        }
+        if (std::find(names.begin(), names.end(), TickerName(key)) != names.end()) continue;
+        names.push_back(TickerName(key));
+        series.push_back(load.series);
+    }
+    if (names.empty()) {
         std::cout << "No data, exiting.\n";
         return 0;
     }
 
-    auto returns = analytics.DailyReturns(data);
-    auto vol20   = analytics.RollingVolatility(data, 20);
-    auto sma20   = analytics.SimpleMovingAverage(data, 20);
+    AlignedPanel panel(names, series);
+    PortfolioSpec spec;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "PORTFOLIO BACKTEST\n";
+    std::cout << std::string(60, '=') << "\n";
+    std::cout << "\n" << panel.cols() << " tickers on " << panel.rows() << " trading days ("
+              << FormatDate(panel.Dates().front()) << " to " << FormatDate(panel.Dates().back())
+              << "), rebalanced every " << spec.rebalanceEvery << " days\n";
+    for (size_t j = 0; j < panel.cols(); ++j) {
+        std::cout << "  " << std::left << std::setw(8) << panel.Tickers()[j] << std::right
+                  << FormatDate(panel.Dates()[panel.FirstRow(j)]) << " to "
+                  << FormatDate(panel.Dates()[panel.LastRow(j)]) << "\n";
+    }
+
+    std::cout << "\n" << std::left << std::setw(28) << "Strategy" << std::right
+              << std::setw(12) << "Return%" << std::setw(9) << "Sharpe"
+              << std::setw(9) << "MaxDD%" << std::setw(9) << "Win%"
+              << std::setw(11) << "Turnover" << std::setw(12) << "Rebalances" << "\n";
+    std::cout << std::string(90, '-') << "\n";
+    auto strategies = DefaultStrategies();
+    for (auto& strategy : strategies) {
+        PortfolioResult result = RunPortfolio(panel, *strategy, spec);
+        const BacktestResult& p = result.performance;
+        std::cout << std::left << std::setw(28) << strategy->getName() << std::right
+                  << std::setw(12) << p.totalReturn * 100.0
+                  << std::setw(9) << std::setprecision(4) << p.sharpeRatio << std::setprecision(2)
+                  << std::setw(9) << p.maxDrawdown * 100.0
+                  << std::setw(9) << p.winRate * 100.0
+                  << std::setw(11) << p.turnover
+                  << std::setw(12) << result.rebalances << "\n";
+    }
+    return 0;
+}
 
-    ReturnStats stats = analytics.ComputeReturnStats(returns);
-    double sharpe     = analytics.SharpeRatio(returns, 0.0);  // assume 0 risk-free
-    double ytd        = analytics.YearToDatePerformance(data);
-    double maxDD      = analytics.MaxDrawdown(data);
+// ============================================================
+// PARAMETER GRID SEARCH
+// ============================================================
+void PrintGridSearch(const PriceSeries& data) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "PARAMETER GRID SEARCH\n";
+    std::cout << std::string(60, '=') << "\n";
 
-    std::vector<double> midBB, upBB, lowBB;
-    analytics.BollingerBands(data, 20, midBB, upBB, lowBB, 2.0);
+    GridSearch grid(data);
+    std::vector<GridResult> results = grid.Run();
+    const size_t shown = std::min<size_t>(results.size(), 20);
+
+    std::cout << "\nTop " << shown << " of " << results.size() << " parameter sets:\n";
+    std::cout << std::left << std::setw(28) << "Strategy" << std::right
+              << std::setw(8) << "Window" << std::setw(8) << "Thresh"
+              << std::setw(10) << "Lookback" << std::setw(11) << "Return%"
+              << std::setw(9) << "Sharpe" << std::setw(9) << "MaxDD%"
+              << std::setw(9) << "Win%" << std::setw(9) << "Score" << "\n";
+    std::cout << std::string(101, '-') << "\n";
+    std::cout << std::setprecision(2);
+    for (size_t i = 0; i < shown; ++i) {
+        const GridResult& r = results[i];
+        const StrategyPerformance& p = r.performance;
+        std::cout << std::left << std::setw(28) << r.strategy << std::right
+                  << std::setw(8);
+        if (r.window > 0) std::cout << r.window; else std::cout << "-";
+        std::cout << std::setw(8);
+        if (!std::isnan(r.threshold)) std::cout << r.threshold; else std::cout << "-";
+        std::cout << std::setw(10) << r.lookback
+                  << std::setw(11) << p.totalReturn * 100.0
+                  << std::setw(9) << p.sharpeRatio
+                  << std::setw(9) << p.maxDrawdown * 100.0
+                  << std::setw(9) << p.winRate * 100.0
+                  << std::setw(9) << p.score << "\n";
+    }
+}
+
+// ============================================================
+// WALK-FORWARD OPTIMIZATION
+// ============================================================
+void PrintWalkForward(const PriceSeries& data) {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "WALK-FORWARD OPTIMIZATION\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    WalkForwardSpec spec;
+    WalkForwardReport report = WalkForward(data).Run(spec);
+    std::cout << std::setprecision(2);
+    std::cout << "\n" << report.folds.size() << " folds (train " << spec.trainBars
+              << " bars, test " << spec.testBars << " bars)\n";
+
+    const size_t shown = std::min<size_t>(report.folds.size(), 10);
+    if (shown > 0) {
+        std::cout << "\nLast " << shown << " folds:\n";
+        std::cout << std::left << std::setw(12) << "Test start" << std::setw(28) << "Chosen strategy"
+                  << std::right << std::setw(8) << "Window" << std::setw(8) << "Thresh"
+                  << std::setw(12) << "Train ret%" << std::setw(12) << "Test ret%" << "\n";
+        std::cout << std::string(80, '-') << "\n";
+    }
+    for (size_t f = report.folds.size() - shown; f < report.folds.size(); ++f) {
+        const WalkForwardFold& fold = report.folds[f];
+        std::cout << std::left << std::setw(12) << FormatDate(data.Date(fold.testBegin))
+                  << std::setw(28) << fold.best.strategy << std::right << std::setw(8);
+        if (fold.best.window > 0) std::cout << fold.best.window; else std::cout << "-";
+        std::cout << std::setw(8);
+        if (!std::isnan(fold.best.threshold)) std::cout << fold.best.threshold; else std::cout << "-";
+        std::cout << std::setw(12) << fold.best.performance.totalReturn * 100.0
+                  << std::setw(12) << fold.outOfSample.totalReturn * 100.0 << "\n";
+    }
+
+    const StrategyPerformance& oos = report.stitched;
+    std::cout << "\nStitched out-of-sample results:\n";
+    std::cout << "  Total Return:               " << oos.totalReturn * 100.0 << "%\n";
+    std::cout << "  Sharpe Ratio:               " << oos.sharpeRatio << "\n";
+    std::cout << "  Max Drawdown:               " << oos.maxDrawdown * 100.0 << "%\n";
+    std::cout << "  Win Rate:                   " << oos.winRate * 100.0 << "%\n";
+}
+
+// Full report for one ticker
+int TickerMode(const Options& options) {
+    StockDataLoader loader;
+    auto data = loader.LoadByTicker(options.ticker);
+    std::cout << "Loaded " << data.size() << " rows for " << options.ticker << ".\n";
+
+    if (data.empty()) {
+        std::cout << "No data, exiting.\n";
+        return 0;
+    }
+
+    // Indicators (one fused pass over the closes), strategy selection and
+    // the current signal, exactly as the universe mode computes them
+    TickerAnalysis analysis = AnalyzeSeries(options.ticker, data);
+    const IndicatorResults& ind = analysis.indicators;
+
+    const ReturnStats& stats = ind.stats;
+    const std::vector<double>& sma20 = ind.sma;
+    const std::vector<double>& vol20 = ind.volatility;
+    const std::vector<double>& midBB = ind.bollingerMiddle;
+    const std::vector<double>& upBB = ind.bollingerUpper;
+    const std::vector<double>& lowBB = ind.bollingerLower;
+    double sharpe = ind.sharpe;  // assume 0 risk-free
+    double ytd    = ind.periodReturn;
+    double maxDD  = ind.maxDrawdown;
 
-    const auto& last = data.back();
     size_t lastIdx = data.size() - 1;
+    const StockData last = data.Bar(lastIdx);
 
     std::cout << std::fixed << std::setprecision(4);
 
     std::cout << "\n--- Analysis Summary ---\n";
-    std::cout << "Latest date:                " << last.date << "\n";
+    std::cout << "Latest date:                " << FormatDate(last.date) << "\n";
     std::cout << "Latest close:               " << last.close << "\n";
     std::cout << "20-day SMA:                 " << sma20[lastIdx] << "\n";
     std::cout << "20-day volatility:          " << vol20[lastIdx] << "\n";
@@ -110,7 +658,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Autocorrelation analysis
-    auto acf = analytics.AutocorrelationFunction(returns, 20);
+    const std::vector<double>& acf = ind.autocorrelation.acf;
     
     std::cout << "\nAutocorrelation Analysis (momentum vs mean reversion):\n";
     std::cout << "  Lag-1 (daily):             " << acf[0] << "\n";
@@ -143,7 +691,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Hurst Exponent analysis
-    double hurst = analytics.HurstExponent(returns);
+    double hurst = ind.hurst;
     
     std::cout << "\nHurst Exponent Analysis:\n";
     std::cout << "  Hurst Exponent:            " << hurst << "\n";
@@ -171,15 +719,9 @@ int main(int argc, char* argv[]) {
     std::cout << "AUTOMATED STRATEGY SELECTION\n";
     std::cout << std::string(60, '=') << "\n";
 
-    // Create candidate strategies
-    std::vector<std::unique_ptr<AnalysisStrategy>> strategies;
-    strategies.push_back(std::make_unique<TrendingStrategy>());
-    strategies.push_back(std::make_unique<MeanReversionStrategy>());
-    strategies.push_back(std::make_unique<BuyAndHoldStrategy>());
-
-    // Evaluate all strategies
-    StrategySelector selector;
-    auto performances = selector.evaluateAllStrategies(strategies, data);
+    // All candidates were backtested once, in parallel; ranking and best come together
+    const StrategyEvaluation& evaluation = analysis.evaluation;
+    const std::vector<StrategyPerformance>& performances = evaluation.ranking;
 
     std::cout << "\nStrategy Backtest Results (Last 100 Days):\n";
     std::cout << std::string(60, '-') << "\n";
@@ -193,17 +735,16 @@ int main(int argc, char* argv[]) {
         std::cout << "  Overall Score:              " << perf.score << "\n";
     }
 
-    // Select the best strategy
-    StrategyPerformance bestPerf;
-    AnalysisStrategy* bestStrategy = selector.selectBestStrategy(strategies, data, bestPerf);
+    // Best strategy from the same evaluation
+    const StrategyPerformance& bestPerf = evaluation.bestPerformance;
 
     std::cout << "\n" << "\n";
     std::cout << "RECOMMENDED STRATEGY: " << bestPerf.strategyName << "\n";
     std::cout << "\n" << "\n";
     std::cout << "Based on comparative performance, this strategy has shown the best risk-adjusted returns.\n";
 
-    // Get current signal from the best strategy
-    double signal = bestStrategy->analyze(data);
+    // Current signal from the best strategy
+    double signal = analysis.signal;
     
     std::cout << "\nCurrent Signal Strength:     " << signal << "\n";
     std::cout << "\nAction Recommendation:\n";
@@ -225,6 +766,30 @@ int main(int argc, char* argv[]) {
         std::cout << "  Strategy indicates exit conditions.\n";
     }
 
-
+    if (options.runGrid) PrintGridSearch(data);
+    if (options.runWalkForward) PrintWalkForward(data);
     return 0;
 }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::string error;
+    if (!ParseOptions(argc, argv, options, error)) {
+        std::cerr << error << "\n" << kUsage;
+        return 1;
+    }
+    if (options.help) {
+        std::cout << kUsage;
+        return 0;
+    }
+
+    if (options.serve) return ServeMode(options);
+    if (options.stream) return StreamMode(options);
+    if (options.replay) return ReplayMode(options);
+    if (options.format != OutputFormat::Text) return MachineReadableMode(options);
+    if (!options.universe.empty()) return UniverseMode(options);
+    if (!options.portfolio.empty()) return PortfolioMode(options);
+    return TickerMode(options);
+}
@@ -0,0 +1,114 @@
+"""Replay bundled CSVs as a live bar feed for `stocks --stream`.
+
+    python3 replay_bars.py AAPL.csv NVDA.csv | ./stocks --stream
+    python3 replay_bars.py --binary --socket stream.sock --rate 500 *.csv
+
+The files are merged by date, so tickers interleave the way a real feed
+would deliver them. Bars go to stdout, or with --socket to a running
+`stocks --stream --socket <path>`. --rate limits the feed to that many bars
+per second (default: as fast as possible).
+"""
+import argparse
+import csv
+import socket
+import struct
+import sys
+import time
+from datetime import date, datetime
+from pathlib import Path
+
+# StreamEngine.h: "SSB1", then StreamBarRecord {char[8], int32 date, uint32 0,
+# 5 x double} in host byte order
+MAGIC = b"SSB1"
+RECORD = struct.Struct("=8siI5d")
+EPOCH = date(1970, 1, 1)
+
+
+def parse_date(text):
+    text = text[:10]
+    for fmt in ("%Y-%m-%d", "%d-%m-%Y", "%Y/%m/%d", "%d/%m/%Y"):
+        try:
+            return datetime.strptime(text, fmt).date()
+        except ValueError:
+            pass
+    return None
+
+
+def read_bars(path):
+    """(date, ticker, open, high, low, close, volume) for each row of a CSV"""
+    ticker = Path(path).stem.upper()
+    with open(path, newline="") as f:
+        rows = csv.reader(f)
+        header = [h.strip().lower() for h in next(rows)]
+        column = {name: header.index(name) for name in ("date", "open", "high", "low", "close", "volume")
+                  if name in header}
+        if "date" not in column or "close" not in column:
+            raise SystemExit(f"{path}: needs date and close columns")
+        for row in rows:
+            try:
+                day = parse_date(row[column["date"]])
+                values = [float(row[column[name]]) if name in column else float(row[column["close"]])
+                          for name in ("open", "high", "low", "close")]
+                volume = float(row[column["volume"]]) if "volume" in column else 0.0
+            except (ValueError, IndexError):
+                continue
+            if day is not None:
+                yield (day, ticker, *values, volume)
+
+
+def encode(bar, binary):
+    day, ticker, o, h, l, c, v = bar
+    if binary:
+        name = ticker.encode()
+        if len(name) > 8:
+            raise SystemExit(f"{ticker}: binary records hold 8-byte tickers, use the line protocol")
+        return RECORD.pack(name, (day - EPOCH).days, 0, o, h, l, c, v)
+    return f"{ticker},{day.isoformat()},{o!r},{h!r},{l!r},{c!r},{v!r}\n".encode()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("csv", nargs="+")
+    parser.add_argument("--binary", action="store_true", help="binary protocol instead of lines")
+    parser.add_argument("--socket", help="send to this Unix socket instead of stdout")
+    parser.add_argument("--rate", type=float, default=0.0, help="bars per second (0: unthrottled)")
+    args = parser.parse_args()
+
+    bars = sorted((bar for path in args.csv for bar in read_bars(path)), key=lambda b: (b[0], b[1]))
+
+    if args.socket:
+        conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        conn.connect(args.socket)
+        write = conn.sendall
+    else:
+        conn = None
+        write = sys.stdout.buffer.write
+
+    batch = bytearray(MAGIC if args.binary else b"")
+    start = time.perf_counter()
+    try:
+        for i, bar in enumerate(bars):
+            batch += encode(bar, args.binary)
+            if args.rate > 0:
+                # Send each bar on its own once it is due
+                delay = start + i / args.rate - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+                write(bytes(batch))
+                if conn is None:
+                    sys.stdout.flush()
+                batch.clear()
+            elif len(batch) >= 65536:
+                write(bytes(batch))
+                batch.clear()
+        write(bytes(batch))
+    except BrokenPipeError:
+        pass
+    finally:
+        if conn is not None:
+            conn.close()
+    print(f"Replayed {len(bars)} bars", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
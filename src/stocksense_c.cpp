@@ -0,0 +1,288 @@
+#include "stocksense_c.h"
+#include "ArrowExport.h"
+#include "StockDataLoader.h"
+#include "Universe.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Everything the C API hands out points into one of these (or into the series
+// storage it keeps alive)
+struct AnalysisData {
+    TickerAnalysis analysis;
+    std::vector<double> signals;     // SS_COL_SIGNAL
+    std::string bollingerStatus;
+
+    // ss_report_json results, rendered on first request
+    mutable std::once_flag jsonOnce[2];
+    mutable std::string json[2];
+};
+
+} // namespace
+
+// The handle behind ss_analysis*. ss_free() drops its reference, ending every
+// borrowed lifetime at once; Arrow exports hold their own.
+struct ss_analysis {
+    std::shared_ptr<const AnalysisData> data;
+};
+
+namespace {
+
+thread_local std::string gLastError;
+
+void SetError(std::string message) { gLastError = std::move(message); }
+
+// Loads share one loader, like the server does; it is safe to use concurrently
+StockDataLoader& Loader() {
+    static StockDataLoader loader;
+    return loader;
+}
+
+const std::vector<double>& Empty() {
+    static const std::vector<double> empty;
+    return empty;
+}
+
+double Last(const std::vector<double>& values) {
+    return values.empty() ? std::numeric_limits<double>::quiet_NaN() : values.back();
+}
+
+// Wraps a finished TickerAnalysis in a handle, or records why there is none
+ss_analysis* Finish(TickerAnalysis analysis) {
+    if (analysis.load.status != LoadStatus::Ok || analysis.load.series.empty()) {
+        SetError(analysis.load.error.empty() ? "no data for " + analysis.ticker : analysis.load.error);
+        return nullptr;
+    }
+    auto shared = std::make_shared<AnalysisData>();
+    shared->analysis = std::move(analysis);
+    const TickerAnalysis& a = shared->analysis;
+    const PriceSeries& data = a.load.series;
+    if (a.evaluation.best) {
+        shared->signals = a.evaluation.best->analyzeSeries(data);
+    } else {
+        shared->signals.assign(data.size(), std::numeric_limits<double>::quiet_NaN());
+    }
+    const IndicatorResults& ind = a.indicators;
+    shared->bollingerStatus = BollingerStatus(data.Close().back(), Last(ind.bollingerMiddle),
+                                              Last(ind.bollingerUpper), Last(ind.bollingerLower));
+    return new ss_analysis{ std::move(shared) };
+}
+
+// Copies the fields of a filled struct that fit in the caller's struct_size
+template <typename T>
+int CopyOut(const T& filled, T* out) {
+    if (out == nullptr || out->struct_size < sizeof(uint32_t)) {
+        SetError("output struct_size not set");
+        return -1;
+    }
+    size_t size = std::min<size_t>(out->struct_size, sizeof(T));
+    uint32_t callerSize = out->struct_size;
+    std::memcpy(out, &filled, size);
+    out->struct_size = callerSize;
+    return 0;
+}
+
+} // namespace
+
+extern "C" {
+
+int ss_abi_version(void) { return SS_ABI_VERSION; }
+
+const char* ss_last_error(void) { return gLastError.c_str(); }
+
+ss_analysis* ss_analyze_ticker(const char* ticker, int allow_fetch) {
+    if (ticker == nullptr || *ticker == '\0') {
+        SetError("ticker is empty");
+        return nullptr;
+    }
+    try {
+        return Finish(AnalyzeTicker(Loader(), ticker, allow_fetch != 0));
+    } catch (const std::exception& e) {
+        SetError(e.what());
+    } catch (...) {
+        SetError("unknown error");
+    }
+    return nullptr;
+}
+
+ss_analysis* ss_analyze_series(const char* ticker, size_t rows, const int32_t* dates,
+                               const double* open, const double* high, const double* low,
+                               const double* close, const double* volume) {
+    if (rows == 0 || dates == nullptr || close == nullptr) {
+        SetError("dates and close are required and rows must be positive");
+        return nullptr;
+    }
+    try {
+        PriceSeriesBuilder builder;
+        builder.Reserve(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            builder.Append(dates[i], open ? open[i] : close[i], high ? high[i] : close[i],
+                           low ? low[i] : close[i], close[i], volume ? volume[i] : 0.0);
+        }
+        return Finish(AnalyzeSeries(ticker ? ticker : "", builder.Build()));
+    } catch (const std::exception& e) {
+        SetError(e.what());
+    } catch (...) {
+        SetError("unknown error");
+    }
+    return nullptr;
+}
+
+void ss_free(ss_analysis* analysis) { delete analysis; }
+
+const char* ss_ticker(const ss_analysis* analysis) {
+    return analysis ? analysis->data->analysis.ticker.c_str() : nullptr;
+}
+
+const char* ss_source(const ss_analysis* analysis) {
+    return analysis ? analysis->data->analysis.load.source.c_str() : nullptr;
+}
+
+size_t ss_rows(const ss_analysis* analysis) {
+    return analysis ? analysis->data->analysis.load.series.size() : 0;
+}
+
+const int32_t* ss_dates(const ss_analysis* analysis) {
+    return analysis ? analysis->data->analysis.load.series.Dates().data() : nullptr;
+}
+
+const double* ss_column(const ss_analysis* analysis, ss_column_id column) {
+    if (analysis == nullptr) {
+        SetError("analysis is NULL");
+        return nullptr;
+    }
+    const PriceSeries& data = analysis->data->analysis.load.series;
+    const IndicatorResults& ind = analysis->data->analysis.indicators;
+    const std::vector<double>* values = &Empty();
+    switch (column) {
+    case SS_COL_OPEN: return data.Open().data();
+    case SS_COL_HIGH: return data.High().data();
+    case SS_COL_LOW: return data.Low().data();
+    case SS_COL_CLOSE: return data.Close().data();
+    case SS_COL_VOLUME: return data.Volume().data();
+    case SS_COL_RETURN: values = &ind.returns; break;
+    case SS_COL_SMA: values = &ind.sma; break;
+    case SS_COL_VOLATILITY: values = &ind.volatility; break;
+    case SS_COL_BB_MIDDLE: values = &ind.bollingerMiddle; break;
+    case SS_COL_BB_UPPER: values = &ind.bollingerUpper; break;
+    case SS_COL_BB_LOWER: values = &ind.bollingerLower; break;
+    case SS_COL_SIGNAL: values = &analysis->data->signals; break;
+    default:
+        SetError("unknown column " + std::to_string(static_cast<int>(column)));
+        return nullptr;
+    }
+    if (values->size() != data.size()) {
+        SetError("column not computed");
+        return nullptr;
+    }
+    return values->data();
+}
+
+const double* ss_acf(const ss_analysis* analysis, size_t* lags) {
+    if (analysis == nullptr) {
+        SetError("analysis is NULL");
+        if (lags) *lags = 0;
+        return nullptr;
+    }
+    const std::vector<double>& acf = analysis->data->analysis.indicators.autocorrelation.acf;
+    if (lags) *lags = acf.size();
+    return acf.data();
+}
+
+int ss_get_summary(const ss_analysis* analysis, ss_summary* out) {
+    if (analysis == nullptr) {
+        SetError("analysis is NULL");
+        return -1;
+    }
+    const TickerAnalysis& a = analysis->data->analysis;
+    const PriceSeries& data = a.load.series;
+    const IndicatorResults& ind = a.indicators;
+
+    ss_summary s{};
+    s.struct_size = sizeof(ss_summary);
+    s.latest_date = data.Date(data.size() - 1);
+    s.latest_close = data.Close().back();
+    s.sma20 = Last(ind.sma);
+    s.volatility20 = Last(ind.volatility);
+    s.return_mean = ind.stats.mean;
+    s.return_stddev = ind.stats.stddev;
+    s.return_max = ind.stats.max;
+    s.return_min = ind.stats.min;
+    s.sharpe = ind.sharpe;
+    s.period_return = ind.periodReturn;
+    s.max_drawdown = ind.maxDrawdown;
+    s.bollinger_middle = Last(ind.bollingerMiddle);
+    s.bollinger_upper = Last(ind.bollingerUpper);
+    s.bollinger_lower = Last(ind.bollingerLower);
+    s.hurst = ind.hurst;
+    s.signal = a.signal;
+    s.bollinger_status = analysis->data->bollingerStatus.c_str();
+    s.hurst_behavior = HurstBehavior(ind.hurst);
+    s.recommended = a.evaluation.best ? a.evaluation.bestPerformance.strategyName.c_str() : "";
+    s.action = std::isnan(a.signal) ? "" : SignalAction(a.signal);
+    return CopyOut(s, out);
+}
+
+size_t ss_strategy_count(const ss_analysis* analysis) {
+    return analysis ? analysis->data->analysis.evaluation.ranking.size() : 0;
+}
+
+int ss_get_strategy(const ss_analysis* analysis, size_t rank, ss_strategy* out) {
+    if (analysis == nullptr || rank >= analysis->data->analysis.evaluation.ranking.size()) {
+        SetError(analysis ? "strategy rank out of range" : "analysis is NULL");
+        return -1;
+    }
+    const StrategyPerformance& perf = analysis->data->analysis.evaluation.ranking[rank];
+    ss_strategy s{};
+    s.struct_size = sizeof(ss_strategy);
+    s.name = perf.strategyName.c_str();
+    s.total_return = perf.totalReturn;
+    s.sharpe = perf.sharpeRatio;
+    s.max_drawdown = perf.maxDrawdown;
+    s.win_rate = perf.winRate;
+    s.score = perf.score;
+    return CopyOut(s, out);
+}
+
+const char* ss_report_json(const ss_analysis* analysis, int include_series) {
+    if (analysis == nullptr) {
+        SetError("analysis is NULL");
+        return nullptr;
+    }
+    const int variant = include_series ? 1 : 0;
+    try {
+        std::call_once(analysis->data->jsonOnce[variant], [&] {
+            analysis->data->json[variant] = AnalysisJson(analysis->data->analysis, include_series != 0);
+        });
+    } catch (const std::exception& e) {
+        SetError(e.what());
+        return nullptr;
+    }
+    return analysis->data->json[variant].c_str();
+}
+
+int ss_export_arrow(const ss_analysis* analysis, struct ArrowSchema* schema, struct ArrowArray* array) {
+    if (analysis == nullptr || schema == nullptr || array == nullptr) {
+        SetError("analysis, schema and array are required");
+        return -1;
+    }
+    try {
+        const AnalysisData& data = *analysis->data;
+        ExportArrowTable(analysis->data, data.analysis.load.series.size(),
+                         AnalysisArrowColumns(data.analysis, &data.signals), schema, array);
+    } catch (const std::exception& e) {
+        SetError(e.what());
+        return -1;
+    }
+    return 0;
+}
+
+} // extern "C"
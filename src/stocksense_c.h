@@ -0,0 +1,206 @@
+/* C interface to the StockSense analytics (libstocksense).
+ *
+ * Loads a ticker, computes the indicator pipeline and runs the strategy
+ * selection in-process, exactly as `stocks <ticker>` does, and hands the
+ * results out without copying:
+ *
+ *   ss_analysis* a = ss_analyze_ticker("NVDA", 1);
+ *   if (!a) { fprintf(stderr, "%s\n", ss_last_error()); return 1; }
+ *   const double* sma = ss_column(a, SS_COL_SMA);      // ss_rows(a) values
+ *   ss_summary s = { sizeof(ss_summary) };
+ *   ss_get_summary(a, &s);
+ *   ss_free(a);                                         // sma, s.action, ... now dangle
+ *
+ * Ownership: every pointer returned by the library (arrays, strings, the
+ * strings inside ss_summary and ss_strategy) is borrowed from the analysis
+ * handle. It stays valid and unchanged until ss_free() on that handle and
+ * must not be written to or freed by the caller.
+ *
+ * Threads: a handle is immutable once returned, so any number of threads
+ * may read it (including ss_report_json) concurrently. Analyses may be
+ * created concurrently. ss_last_error() is per thread.
+ *
+ * Arrow: ss_export_arrow() hands the same columns to pyarrow, pandas,
+ * polars, etc. through the Arrow C Data Interface, also without copying.
+ *
+ * Errors: functions returning a pointer return NULL, functions returning
+ * int return -1; ss_last_error() then says why. No C++ exception crosses
+ * this interface.
+ *
+ * Build (from src):
+ *   g++ -std=c++17 -O2 -fPIC -shared -fvisibility=hidden stocksense_c.cpp
+ *       StockDataLoader.cpp StockAnalytics.cpp MappedFile.cpp
+ *       PriceCsvParser.cpp SeriesCache.cpp Fft.cpp SimdKernels.cpp
+ *       IndicatorPipeline.cpp Universe.cpp ArrowExport.cpp
+ *       -o libstocksense.so -lpthread -lcurl
+ */
+#ifndef STOCKSENSE_C_H
+#define STOCKSENSE_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SS_API __declspec(dllexport)
+#else
+#define SS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Arrow C Data Interface structs, verbatim from the specification
+ * (https://arrow.apache.org/docs/format/CDataInterface.html). The guard
+ * lets them coexist with Arrow's own headers and ArrowExport.h. */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+/* Bumped whenever a signature, enum value or struct layout changes
+ * incompatibly. Structs only ever grow at the end; see struct_size. */
+#define SS_ABI_VERSION 1
+
+typedef struct ss_analysis ss_analysis;
+
+/* Per-bar columns, each ss_rows() doubles long */
+typedef enum ss_column_id {
+    SS_COL_OPEN = 0,
+    SS_COL_HIGH = 1,
+    SS_COL_LOW = 2,
+    SS_COL_CLOSE = 3,
+    SS_COL_VOLUME = 4,
+    SS_COL_RETURN = 5,        /* daily return; NaN on the first bar and after a zero close */
+    SS_COL_SMA = 6,           /* 20-day SMA of close; NaN until warmed up */
+    SS_COL_VOLATILITY = 7,    /* 20-day volatility of returns */
+    SS_COL_BB_MIDDLE = 8,     /* Bollinger bands (20 days, 2 sigma) */
+    SS_COL_BB_UPPER = 9,
+    SS_COL_BB_LOWER = 10,
+    SS_COL_SIGNAL = 11        /* the recommended strategy's signal per bar */
+} ss_column_id;
+
+/* Whole-series results and the latest bar. The caller sets struct_size to
+ * sizeof(ss_summary); the library fills only the fields that fit, so code
+ * built against an older header keeps working. */
+typedef struct ss_summary {
+    uint32_t struct_size;
+    int32_t latest_date;          /* days since 1970-01-01 */
+    double latest_close;
+    double sma20;
+    double volatility20;
+    double return_mean;
+    double return_stddev;
+    double return_max;
+    double return_min;
+    double sharpe;
+    double period_return;
+    double max_drawdown;
+    double bollinger_middle;
+    double bollinger_upper;
+    double bollinger_lower;
+    double hurst;
+    double signal;                /* recommended strategy, latest bar */
+    const char* bollinger_status; /* "OVERBOUGHT", ... */
+    const char* hurst_behavior;   /* "TRENDING/PERSISTENT", ...; "" if unknown */
+    const char* recommended;      /* strategy name */
+    const char* action;           /* "STRONG BUY", ... */
+} ss_summary;
+
+/* One row of the strategy backtest table (last 100 days), same struct_size
+ * convention as ss_summary */
+typedef struct ss_strategy {
+    uint32_t struct_size;
+    const char* name;
+    double total_return;
+    double sharpe;
+    double max_drawdown;
+    double win_rate;
+    double score;
+} ss_strategy;
+
+SS_API int ss_abi_version(void);
+
+/* Message for the calling thread's last failure ("" if none) */
+SS_API const char* ss_last_error(void);
+
+/* Load ticker (a symbol such as "NVDA" or a CSV path) like `stocks` does:
+ * local CSV or binary cache first, then the price API if allow_fetch. */
+SS_API ss_analysis* ss_analyze_ticker(const char* ticker, int allow_fetch);
+
+/* Analyze caller-provided bars, which are copied. dates (days since
+ * 1970-01-01) and close are required; open, high, low and volume may be
+ * NULL (open/high/low then repeat close, volume is 0). */
+SS_API ss_analysis* ss_analyze_series(const char* ticker, size_t rows, const int32_t* dates,
+                                      const double* open, const double* high, const double* low,
+                                      const double* close, const double* volume);
+
+/* Release the handle and everything borrowed from it; NULL is ignored */
+SS_API void ss_free(ss_analysis* analysis);
+
+SS_API const char* ss_ticker(const ss_analysis* analysis);
+SS_API const char* ss_source(const ss_analysis* analysis);  /* CSV path or URL */
+SS_API size_t ss_rows(const ss_analysis* analysis);
+
+/* Borrowed arrays of ss_rows() values */
+SS_API const int32_t* ss_dates(const ss_analysis* analysis);
+SS_API const double* ss_column(const ss_analysis* analysis, ss_column_id column);
+
+/* Autocorrelation of returns at lags 1..*lags (borrowed) */
+SS_API const double* ss_acf(const ss_analysis* analysis, size_t* lags);
+
+SS_API int ss_get_summary(const ss_analysis* analysis, ss_summary* out);
+
+/* Backtest table, best first */
+SS_API size_t ss_strategy_count(const ss_analysis* analysis);
+SS_API int ss_get_strategy(const ss_analysis* analysis, size_t rank, ss_strategy* out);
+
+/* Export every per-bar column as one Arrow struct array (a record batch):
+ * date (date32), open, high, low, close, volume, return, sma20,
+ * volatility20, bollinger_middle, bollinger_upper, bollinger_lower and
+ * signal (float64; missing values are NaN, never nulls). The value buffers
+ * are the same memory ss_column() returns, not copies. Unlike borrowed
+ * pointers, the exported structs keep that memory alive by themselves:
+ * they remain valid after ss_free() until the consumer calls their release
+ * callbacks. Fills *schema and *array and returns 0, or returns -1. */
+SS_API int ss_export_arrow(const ss_analysis* analysis, struct ArrowSchema* schema,
+                           struct ArrowArray* array);
+
+/* The `stocks --format=json` report for this analysis, with the per-bar
+ * series when include_series is nonzero (borrowed) */
+SS_API const char* ss_report_json(const ss_analysis* analysis, int include_series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STOCKSENSE_C_H */
@@ -1,21 +1,67 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include "StockData.h"
 #include "StockAnalytics.h"
+#include "SimdKernels.h"
+#include "IndicatorPipeline.h"
+#include "OnlineIndicators.h"
+#include "BacktestKernel.h"
+#include "TrendingStrategy.h"
+#include "MeanReversionStrategy.h"
+#include "BuyAndHoldStrategy.h"
+#include "StrategySelector.h"
+#include "GridSearch.h"
+#include "WalkForward.h"
+#include "Universe.h"
+#include "Portfolio.h"
+#include "StaticStrategy.h"
+#include "JsonWriter.h"
+#include "AnalysisServer.h"
+#include "UnixSocket.h"
+#include "ReportFormat.h"
+#include "ArrowExport.h"
+#include "StreamEngine.h"
+#include "ReplayEngine.h"
+#include "SeriesCache.h"
+#include "MappedFile.h"
+#include "PriceCsvParser.h"
+#include "ThreadPool.h"
+#include "TradingDate.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
 
 bool approxEqual(double a, double b, double eps = 1e-6) {
     return std::fabs(a - b) < eps;
 }
 
+// Buy & hold that counts how often it is backtested
+class CountingStrategy : public BuyAndHoldStrategy {
+public:
+    int runs = 0;
+    std::vector<double> analyzeSeries(const PriceSeries& data) override {
+        ++runs;
+        return BuyAndHoldStrategy::analyzeSeries(data);
+    }
+};
+
 int main() {
     // 5 days of fake closing prices: 100, 110, 120, 130, 140
     std::vector<StockData> data = {
-        {"2025-01-01", 0,0,0,100,0},
-        {"2025-01-02", 0,0,0,110,0},
-        {"2025-01-03", 0,0,0,120,0},
-        {"2025-01-04", 0,0,0,130,0},
-        {"2025-01-05", 0,0,0,140,0}
+        {DaysFromCivil(2025, 1, 1), 0,0,0,100,0},
+        {DaysFromCivil(2025, 1, 2), 0,0,0,110,0},
+        {DaysFromCivil(2025, 1, 3), 0,0,0,120,0},
+        {DaysFromCivil(2025, 1, 4), 0,0,0,130,0},
+        {DaysFromCivil(2025, 1, 5), 0,0,0,140,0}
     };
 
     StockAnalytics analytics;
@@ -67,5 +113,1245 @@ int main() {
         std::cout << "  day " << i << ": " << vol3[i] << "\n";
     }
 
+    // ---- Test 4: Date parsing and formatting ----
+    // Bundled CSVs mix ISO and day-first layouts; both must land on the same epoch day.
+    int32_t iso = 0, dayFirst = 0, withTime = 0, epoch = -1, invalid = 0;
+    bool date_ok =
+        ParseDate("2010-01-04", iso) &&
+        ParseDate("04-01-2010", dayFirst) &&
+        ParseDate("2010-01-04 00:00:00+00:00", withTime) &&
+        ParseDate("1970-01-01", epoch) &&
+        !ParseDate("2023-02-29", invalid) &&
+        !ParseDate("Date", invalid) &&
+        iso == dayFirst && iso == withTime && epoch == 0 &&
+        iso == DaysFromCivil(2010, 1, 4) &&
+        FormatDate(iso) == "2010-01-04" &&
+        FormatDate(DaysFromCivil(2024, 2, 29)) == "2024-02-29";
+
+    std::cout << "Date test: " << (date_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 5: O(n) rolling volatility vs. two-pass reference ----
+    // Long noisy series with a NaN gap, so the sliding updates and the
+    // periodic rebuild both get exercised.
+    std::vector<double> noisy(5000);
+    unsigned seed = 12345;
+    for (size_t i = 0; i < noisy.size(); ++i) {
+        seed = seed * 1103515245u + 12345u;
+        noisy[i] = ((seed >> 8) % 20001) / 1e6 - 0.01;
+    }
+    noisy[0] = noisy[2500] = std::nan("");
+
+    bool vol_ok = true;
+    for (int window : {3, 20, 250}) {
+        auto fast = analytics.RollingVolatility(noisy, window);
+        for (int i = 0; i < static_cast<int>(noisy.size()); ++i) {
+            double mean = 0.0, var = 0.0;
+            int count = 0;
+            for (int j = std::max(0, i - window + 1); j <= i; ++j) {
+                if (!std::isnan(noisy[j])) { mean += noisy[j]; ++count; }
+            }
+            mean /= count;
+            for (int j = std::max(0, i - window + 1); j <= i; ++j) {
+                if (!std::isnan(noisy[j])) var += (noisy[j] - mean) * (noisy[j] - mean);
+            }
+            double expected = (i < window || count <= 1)
+                ? std::nan("") : std::sqrt(var / (count - 1));
+
+            if (std::isnan(expected) != std::isnan(fast[i]) ||
+                (!std::isnan(expected) && !approxEqual(fast[i], expected, 1e-12))) {
+                vol_ok = false;
+            }
+        }
+    }
+
+    std::cout << "Rolling vol O(n) test: " << (vol_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 6: Hurst exponent on white noise ----
+    // Uncorrelated returns should land near 0.5 in both segmentation modes.
+    double hurstOverlap = analytics.HurstExponent(noisy, HurstMode::Overlapping);
+    double hurstBlocks = analytics.HurstExponent(noisy, HurstMode::NonOverlapping);
+    bool hurst_ok =
+        hurstOverlap > 0.35 && hurstOverlap < 0.65 &&
+        hurstBlocks > 0.35 && hurstBlocks < 0.65 &&
+        std::isnan(analytics.HurstExponent(std::vector<double>(10, 0.01)));
+
+    std::cout << "Hurst test: " << (hurst_ok ? "PASS" : "FAIL")
+              << " (overlapping " << hurstOverlap << ", blocks " << hurstBlocks << ")\n";
+
+    // ---- Test 7: FFT autocorrelation vs. per-lag reference ----
+    AcfResult viaFft = analytics.AutocorrelationSpectrum(noisy, 250, AcfMethod::Fft);
+    AcfResult viaDirect = analytics.AutocorrelationSpectrum(noisy, 250, AcfMethod::Direct);
+    bool acf_ok = viaFft.acf.size() == 250 && viaFft.validCount == 4998 &&
+                  approxEqual(viaFft.ljungBoxQ, viaDirect.ljungBoxQ, 1e-6) &&
+                  viaFft.ljungBoxPValue >= 0.0 && viaFft.ljungBoxPValue <= 1.0;
+    for (int lag = 1; lag <= 250; ++lag) {
+        double expected = analytics.Autocorrelation(noisy, lag);
+        if (!approxEqual(viaFft.acf[lag - 1], expected, 1e-9) ||
+            !approxEqual(viaDirect.acf[lag - 1], expected, 1e-12)) {
+            acf_ok = false;
+        }
+    }
+
+    // A series shorter than maxLag sums only n - 1 lags; the p-value must use
+    // that many degrees of freedom, so asking for more lags changes nothing
+    std::vector<double> shortSeries = { 0.01, -0.02, 0.015, 0.003, -0.007, 0.012, -0.004, 0.009 };
+    AcfResult wide = analytics.AutocorrelationSpectrum(shortSeries, 20);
+    AcfResult exact = analytics.AutocorrelationSpectrum(shortSeries, 7);
+    acf_ok = acf_ok && viaFft.ljungBoxLags == 250 &&
+             wide.ljungBoxLags == 7 && exact.ljungBoxLags == 7 &&
+             approxEqual(wide.ljungBoxQ, exact.ljungBoxQ, 1e-15) &&
+             approxEqual(wide.ljungBoxPValue, exact.ljungBoxPValue, 1e-15) &&
+             std::isnan(wide.acf[7]) && std::isnan(wide.acf[19]);
+
+    std::cout << "ACF spectrum test: " << (acf_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 8: SIMD kernels vs. scalar reference at every level ----
+    // Odd lengths exercise the scalar tails; the dip, the zero close and the
+    // NaN exercise the drawdown, returns and reduction edge cases.
+    std::vector<double> prices(1001);
+    double level = 100.0;
+    for (size_t i = 0; i < prices.size(); ++i) {
+        level *= 1.0 + (std::isnan(noisy[i + 1]) ? 0.0 : noisy[i + 1]);
+        prices[i] = level;
+    }
+    prices[300] *= 0.5;
+    prices[700] = 0.0;
+    std::vector<double> withNan = prices;
+    withNan[0] = withNan[513] = std::nan("");
+
+    auto sameValue = [](double a, double b) {
+        return std::isnan(a) ? std::isnan(b) : approxEqual(a, b, 1e-9);
+    };
+    auto sameReduction = [&](const ColumnReduction& a, const ColumnReduction& b) {
+        return a.count == b.count && a.min == b.min && a.max == b.max &&
+               approxEqual(a.sum, b.sum, 1e-6) && approxEqual(a.sumSq, b.sumSq, 1e-3);
+    };
+
+    bool simd_ok = true;
+    const SimdLevel detected = ActiveSimdLevel();
+    for (SimdLevel simdLevel : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 }) {
+        SetSimdLevel(simdLevel);
+        for (size_t n : { 0, 1, 2, 3, 5, 7, 64, 1001 }) {
+            std::vector<double> expected(n), actual(n);
+            ReturnsScalar(prices.data(), n, expected.data());
+            ReturnsKernel(prices.data(), n, actual.data());
+            for (size_t i = 0; i < n; ++i) simd_ok = simd_ok && sameValue(expected[i], actual[i]);
+
+            for (int window : { 0, 1, 2, 3, 4, 5, 20, 250 }) {
+                SlidingMeanScalar(prices.data(), n, window, expected.data());
+                SlidingMeanKernel(prices.data(), n, window, actual.data());
+                for (size_t i = 0; i < n; ++i) simd_ok = simd_ok && sameValue(expected[i], actual[i]);
+            }
+
+            for (const std::vector<double>* column : { &prices, &withNan }) {
+                simd_ok = simd_ok &&
+                    sameReduction(ReduceScalar(column->data(), n), ReduceKernel(column->data(), n)) &&
+                    sameValue(MaxDrawdownScalar(column->data(), n),
+                              MaxDrawdownKernel(column->data(), n));
+            }
+        }
+    }
+    SetSimdLevel(detected);
+
+    std::cout << "SIMD kernels test: " << (simd_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 9: fused pipeline vs. the individual analytics calls ----
+    // Run a longer series first so the second run reuses shrunk outputs.
+    IndicatorPipeline pipeline;
+    pipeline.Run(PriceSeries(std::vector<StockData>(1500, StockData{ 0, 1, 1, 1, 1, 1 })));
+
+    PriceSeriesBuilder builder;
+    for (size_t i = 0; i < prices.size(); ++i) {
+        builder.Append(static_cast<int32_t>(i), prices[i], prices[i], prices[i], prices[i], 0.0);
+    }
+    const PriceSeries series = builder.Build();
+    const IndicatorResults& fused = pipeline.Run(series);
+
+    auto sameSeries = [&](const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!sameValue(a[i], b[i])) return false;
+        }
+        return true;
+    };
+
+    std::vector<double> batchReturns = analytics.DailyReturns(series);
+    std::vector<double> mid, up, low;
+    analytics.BollingerBands(series, 20, mid, up, low, 2.0);
+    ReturnStats batchStats = analytics.ComputeReturnStats(batchReturns);
+
+    bool pipeline_ok =
+        sameSeries(fused.returns, batchReturns) &&
+        sameSeries(fused.sma, analytics.SimpleMovingAverage(series, 20)) &&
+        sameSeries(fused.volatility, analytics.RollingVolatility(series, 20)) &&
+        sameSeries(fused.bollingerMiddle, mid) &&
+        sameSeries(fused.bollingerUpper, up) &&
+        sameSeries(fused.bollingerLower, low) &&
+        sameSeries(fused.autocorrelation.acf, analytics.AutocorrelationFunction(batchReturns, 20)) &&
+        sameValue(fused.stats.mean, batchStats.mean) &&
+        sameValue(fused.stats.stddev, batchStats.stddev) &&
+        fused.stats.min == batchStats.min && fused.stats.max == batchStats.max &&
+        sameValue(fused.sharpe, analytics.SharpeRatio(batchReturns, 0.0)) &&
+        sameValue(fused.periodReturn, analytics.YearToDatePerformance(series)) &&
+        fused.maxDrawdown == analytics.MaxDrawdown(series) &&
+        sameValue(fused.hurst, analytics.HurstExponent(batchReturns));
+
+    // Disabled indicators are skipped entirely
+    IndicatorSpec returnsOnly;
+    returnsOnly.smaWindow = returnsOnly.volatilityWindow = returnsOnly.bollingerWindow = 0;
+    returnsOnly.returnStats = returnsOnly.drawdown = returnsOnly.hurst = false;
+    returnsOnly.acfMaxLag = 0;
+    IndicatorPipeline leanPipeline(returnsOnly);
+    const IndicatorResults& lean = leanPipeline.Run(series);
+    pipeline_ok = pipeline_ok && sameSeries(lean.returns, batchReturns) &&
+                  lean.sma.empty() && lean.volatility.empty() && lean.bollingerMiddle.empty() &&
+                  lean.autocorrelation.acf.empty() && std::isnan(lean.maxDrawdown) &&
+                  std::isnan(lean.stats.mean) && std::isnan(lean.hurst);
+
+    std::cout << "Indicator pipeline test: " << (pipeline_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 10: online indicators vs. batch results ----
+    // Seed on the first 600 bars, then stream the rest one bar at a time;
+    // every streamed value must match the batch output at that index.
+    const size_t seedBars = 600;
+    const PriceSeries head = series.Slice(0, seedBars);
+
+    OnlineSMA onlineSma(20);
+    OnlineEMA onlineEma(20);
+    OnlineVolatility onlineVol(20);
+    OnlineBollinger onlineBands(20, 2.0);
+    OnlineDrawdown onlineDrawdown;
+    OnlineReturnStats onlineStats;
+    onlineSma.Seed(head);
+    onlineEma.Seed(head);
+    onlineVol.Seed(head);
+    onlineBands.Seed(head);
+    onlineDrawdown.Seed(head);
+    onlineStats.Seed(head);
+    OnlineReturn onlineReturn;
+    onlineReturn.Update(prices[seedBars - 1]);
+
+    std::vector<double> sma20 = analytics.SimpleMovingAverage(series, 20);
+    std::vector<double> vol20 = analytics.RollingVolatility(series, 20);
+
+    // EMA reference: SMA of the first 20 prices, then the usual recursion
+    std::vector<double> ema20(prices.size(), std::nan(""));
+    ema20[19] = sma20[19];
+    for (size_t i = 20; i < prices.size(); ++i) {
+        ema20[i] = ema20[i - 1] + (2.0 / 21.0) * (prices[i] - ema20[i - 1]);
+    }
+
+    bool online_ok = sameValue(onlineSma.value(), sma20[seedBars - 1]) &&
+                     onlineVol.value() == vol20[seedBars - 1];
+    for (size_t i = seedBars; i < prices.size(); ++i) {
+        double r = onlineReturn.Update(prices[i]);
+        onlineStats.Update(r);
+        onlineBands.Update(prices[i]);
+        online_ok = online_ok &&
+            sameValue(r, batchReturns[i]) &&
+            sameValue(onlineSma.Update(prices[i]), sma20[i]) &&
+            sameValue(onlineEma.Update(prices[i]), ema20[i]) &&
+            onlineVol.Update(r) == vol20[i] &&
+            onlineBands.middle() == mid[i] &&
+            onlineBands.upper() == up[i] &&
+            onlineBands.lower() == low[i] &&
+            onlineDrawdown.Update(prices[i]) == analytics.MaxDrawdown(series.Slice(0, i + 1));
+    }
+    ReturnStats streamed = onlineStats.stats();
+    online_ok = online_ok &&
+        sameValue(streamed.mean, batchStats.mean) &&
+        sameValue(streamed.stddev, batchStats.stddev) &&
+        streamed.min == batchStats.min && streamed.max == batchStats.max &&
+        sameValue(onlineStats.Sharpe(), analytics.SharpeRatio(batchReturns));
+
+    std::cout << "Online indicators test: " << (online_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 11: strategy signal series vs. per-prefix analyze() ----
+    const PriceSeries window = series.Slice(200, 500);
+    TrendingStrategy trending;
+    MeanReversionStrategy meanReversion;
+    BuyAndHoldStrategy buyAndHold;
+
+    bool signals_ok = true;
+    for (AnalysisStrategy* strategy : std::vector<AnalysisStrategy*>{ &trending, &meanReversion, &buyAndHold }) {
+        std::vector<double> native = strategy->analyzeSeries(window);
+        std::vector<double> generic = strategy->AnalysisStrategy::analyzeSeries(window);
+        signals_ok = signals_ok && native.size() == window.size() && sameSeries(native, generic);
+        for (size_t i = 0; i < window.size(); i += 37) {
+            signals_ok = signals_ok && sameValue(native[i], strategy->analyze(window.Slice(0, i + 1)));
+        }
+    }
+
+    std::cout << "Strategy signal series test: " << (signals_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 12: backtest kernel ----
+    // Prices 100, 110, 99, 99, 108.9 with signals long, short, flat (NaN), long
+    std::vector<StockData> path = {
+        {0, 0,0,0,100,0}, {1, 0,0,0,110,0}, {2, 0,0,0,99,0}, {3, 0,0,0,99,0}, {4, 0,0,0,108.9,0}
+    };
+    const PriceSeries pathSeries(path);
+    std::vector<double> pathSignals = { 8.0, -12.0, std::nan(""), 6.0, 3.0 };
+    BacktestResult bt = RunBacktest(pathSeries.Close(), pathSignals.data(), PositionRule());
+    // In-market returns: +10%, +10% (short a 10% drop), +10% -> equity 1.331
+    bool backtest_ok = bt.trades == 3 && approxEqual(bt.totalReturn, 0.331, 1e-12) &&
+                       bt.winRate == 1.0 && bt.maxDrawdown == 0.0 &&
+                       approxEqual(bt.turnover, 1.0 + 2.0 + 1.0 + 1.0, 1e-12);
+
+    // Buy & hold through the same kernel equals last/first - 1 and the price drawdown
+    // (stopping before the zero close at bar 700)
+    const PriceSeries held = series.Slice(0, 700);
+    BacktestResult hold = RunBacktest(held.Close(), batchReturns.data(), PositionRule::AlwaysLong());
+    backtest_ok = backtest_ok && hold.trades == 699 &&
+                  approxEqual(hold.totalReturn, prices[699] / prices[0] - 1.0, 1e-9) &&
+                  approxEqual(hold.maxDrawdown, analytics.MaxDrawdown(held), 1e-9);
+
+    std::cout << "Backtest kernel test: " << (backtest_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 13: strategy selector evaluation and memoization ----
+    std::vector<std::unique_ptr<AnalysisStrategy>> candidates;
+    candidates.push_back(std::make_unique<TrendingStrategy>());
+    candidates.push_back(std::make_unique<MeanReversionStrategy>());
+    candidates.push_back(std::make_unique<CountingStrategy>());
+    auto* counting = static_cast<CountingStrategy*>(candidates.back().get());
+
+    const PriceSeries upToZero = series.Slice(0, 700);
+    StrategySelector selector(250);
+    StrategyEvaluation evaluation = selector.evaluate(candidates, upToZero);
+    bool selector_ok = evaluation.ranking.size() == 3 && evaluation.best != nullptr &&
+                       evaluation.bestPerformance.score == evaluation.ranking[0].score &&
+                       evaluation.ranking[0].score >= evaluation.ranking[1].score &&
+                       evaluation.ranking[1].score >= evaluation.ranking[2].score;
+
+    // Re-evaluating the same series is served from the cache
+    StrategyPerformance bestAgain;
+    selector_ok = selector_ok &&
+        selector.selectBestStrategy(candidates, upToZero, bestAgain) == evaluation.best &&
+        bestAgain.score == evaluation.bestPerformance.score &&
+        selector.evaluateAllStrategies(candidates, upToZero).size() == 3 &&
+        counting->runs == 1;
+
+    // A different series (or lookback) is backtested again
+    selector.evaluate(candidates, series.Slice(1, 700));
+    StrategySelector(100).evaluate(candidates, upToZero);
+    selector_ok = selector_ok && counting->runs == 3;
+
+    // Results are shared by identity (name and parameters), not by object
+    std::vector<std::unique_ptr<AnalysisStrategy>> sameParameters;
+    sameParameters.push_back(std::make_unique<CountingStrategy>());
+    sameParameters.push_back(std::make_unique<TrendingStrategy>(30));
+    auto* countingCopy = static_cast<CountingStrategy*>(sameParameters.front().get());
+    std::vector<StrategyPerformance> shared = selector.evaluateAllStrategies(sameParameters, upToZero);
+    selector_ok = selector_ok && countingCopy->runs == 0 &&
+                  TrendingStrategy(30).cacheIdentity() != TrendingStrategy().cacheIdentity();
+
+    // Freed storage never matches, even if its address is reused
+    size_t cachedBefore = selector.cacheSize();
+    double firstReturn;
+    {
+        PriceSeries temporary(upToZero.ToBars());
+        firstReturn = selector.evaluate(sameParameters, temporary).ranking.back().totalReturn;
+    }
+    std::vector<StockData> shiftedBars = upToZero.ToBars();
+    for (StockData& bar : shiftedBars) bar.close *= 1.0 + 0.001 * (bar.date % 7);
+    PriceSeries replacement(shiftedBars);
+    StrategyEvaluation reevaluated = selector.evaluate(sameParameters, replacement);
+    selector_ok = selector_ok && countingCopy->runs == 2 && selector.cacheSize() == cachedBefore + 4 &&
+                  reevaluated.ranking.size() == 2 && std::isfinite(firstReturn);
+
+    // The cache is bounded
+    for (size_t offset = 0; offset < 150; ++offset) {
+        selector.evaluate(sameParameters, series.Slice(offset, offset + 300));
+    }
+    selector_ok = selector_ok && selector.cacheSize() <= 256;
+    selector.clearCache();
+    selector_ok = selector_ok && selector.cacheSize() == 0;
+
+    std::cout << "Strategy selector test: " << (selector_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 14: grid search vs. selector backtests of the same parameters ----
+    GridSearchSpec gridSpec;
+    gridSpec.trendWindows = { 30, 50 };
+    gridSpec.reversionWindows = { 15 };
+    gridSpec.thresholds = { 2.5, 5.0 };
+    gridSpec.lookbacks = { 250, 690 };  // 690 + 20 > 700 bars: skipped
+    std::vector<GridResult> gridResults = GridSearch(upToZero).Run(gridSpec);
+
+    bool grid_ok = gridResults.size() == 2 * 3 + 1;
+    for (size_t i = 0; i < gridResults.size(); ++i) {
+        const GridResult& r = gridResults[i];
+        if (i > 0 && r.performance.score > gridResults[i - 1].performance.score) grid_ok = false;
+
+        std::vector<std::unique_ptr<AnalysisStrategy>> single;
+        if (r.window == 0) {
+            single.push_back(std::make_unique<BuyAndHoldStrategy>());
+        } else if (r.strategy == TrendingStrategy().getName()) {
+            single.push_back(std::make_unique<TrendingStrategy>(r.window, r.threshold));
+        } else {
+            single.push_back(std::make_unique<MeanReversionStrategy>(r.window, r.threshold));
+        }
+        StrategyPerformance expected = StrategySelector(r.lookback).evaluate(single, upToZero).ranking[0];
+        grid_ok = grid_ok && r.lookback == 250 &&
+                  expected.strategyName == r.strategy &&
+                  approxEqual(r.performance.totalReturn, expected.totalReturn, 1e-9) &&
+                  approxEqual(r.performance.maxDrawdown, expected.maxDrawdown, 1e-9) &&
+                  r.performance.winRate == expected.winRate &&
+                  r.performance.turnover == expected.turnover;
+    }
+
+    // Prefix-sum indicators agree with the batch functions on a slice
+    const PrefixIndicators prefix(upToZero);
+    std::vector<double> sliceSma = analytics.SimpleMovingAverage(upToZero.Slice(100, 700), 15);
+    std::vector<double> sliceVol = analytics.RollingVolatility(upToZero.Slice(100, 700), 15);
+    for (size_t i = 0; i < sliceSma.size(); ++i) {
+        grid_ok = grid_ok &&
+            sameValue(prefix.Sma(100 + i, 15, 100), sliceSma[i]) &&
+            sameValue(prefix.Volatility(100 + i, 15, 100), sliceVol[i]);
+    }
+
+    std::cout << "Grid search test: " << (grid_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 15: walk-forward folds ----
+    WalkForwardSpec wfSpec;
+    wfSpec.trainBars = 200;
+    wfSpec.testBars = 60;
+    wfSpec.grid = gridSpec;
+    WalkForwardReport wf = WalkForward(upToZero).Run(wfSpec);
+
+    // Test windows tile bars [200, 680) and the last one ends before bar 699
+    bool wf_ok = wf.folds.size() == 8 && wf.folds.back().testEnd == 680;
+    double chained = 1.0;
+    const PrefixIndicators fullPrefix(upToZero);
+    std::vector<GridPoint> wfPoints = GridPoints(wfSpec.grid, wfSpec.trainBars);
+    for (size_t f = 0; f < wf.folds.size(); ++f) {
+        const WalkForwardFold& fold = wf.folds[f];
+        wf_ok = wf_ok && fold.trainBegin == f * 60 && fold.trainEnd == fold.testBegin &&
+                fold.testEnd == fold.testBegin + 60;
+        chained *= 1.0 + fold.outOfSample.totalReturn;
+
+        // The chosen point scores at least as well as every candidate in sample
+        for (const GridPoint& point : wfPoints) {
+            const PriceColumn trainClose(upToZero.Close().data() + fold.trainBegin, 201);
+            BacktestResult r = RunBacktestWith(trainClose, [&](size_t i) {
+                return GridPosition(fullPrefix, point, fold.trainBegin + i, 0);
+            });
+            double score = MakePerformance("", r).score;
+            wf_ok = wf_ok && !(score > fold.best.performance.score + 1e-12);
+        }
+    }
+    // Stitched out-of-sample equity is the chain of the fold test windows
+    wf_ok = wf_ok && approxEqual(wf.stitched.totalReturn, chained - 1.0, 1e-9);
+
+    // A long history is evaluated in several position blocks; folds on either
+    // side of a block boundary match a direct backtest of their chosen point
+    PriceSeriesBuilder longBuilder;
+    for (int i = 0; i < 20000; ++i) {
+        double c = 100.0 + 0.002 * i + 8.0 * std::sin(i / 37.0) + 3.0 * std::sin(i / 5.3);
+        longBuilder.Append(i, c, c, c, c, 1000.0);
+    }
+    const PriceSeries longSeries = longBuilder.Build();
+    WalkForwardSpec longSpec;
+    longSpec.grid = gridSpec;
+    WalkForwardReport longWf = WalkForward(longSeries).Run(longSpec);
+    const PrefixIndicators longPrefix(longSeries);
+    std::vector<GridPoint> longPoints = GridPoints(longSpec.grid, longSpec.trainBars);
+    double longChained = 1.0;
+    for (const WalkForwardFold& fold : longWf.folds) longChained *= 1.0 + fold.outOfSample.totalReturn;
+    wf_ok = wf_ok && longWf.folds.size() == 394 &&
+            approxEqual(longWf.stitched.totalReturn, longChained - 1.0, 1e-9);
+
+    // The prefix-sum volatility walk-forward uses stays within its documented
+    // relative 1e-10 of the streamed RollingVolatility over the long history
+    for (int window : longSpec.grid.reversionWindows) {
+        std::vector<double> longVol = analytics.RollingVolatility(longSeries, window);
+        for (size_t i = 0; i < longVol.size(); ++i) {
+            double prefixVol = longPrefix.Volatility(i, window);
+            wf_ok = wf_ok && (std::isnan(longVol[i]) ? std::isnan(prefixVol)
+                                                     : std::fabs(prefixVol - longVol[i]) <= 1e-10 * longVol[i]);
+        }
+    }
+    for (size_t f : { size_t(0), size_t(162), size_t(163), size_t(326), size_t(393) }) {
+        const WalkForwardFold& fold = longWf.folds[f];
+        bool matched = false;
+        for (const GridPoint& point : longPoints) {
+            if (GridStrategyName(point.strategy) != fold.best.strategy || point.window != fold.best.window ||
+                !(point.threshold == fold.best.threshold ||
+                  (std::isnan(point.threshold) && std::isnan(fold.best.threshold)))) {
+                continue;
+            }
+            const PriceColumn testClose(longSeries.Close().data() + fold.testBegin, 51);
+            BacktestResult r = RunBacktestWith(testClose, [&](size_t i) {
+                return GridPosition(longPrefix, point, fold.testBegin + i, 0);
+            });
+            matched = r.totalReturn == fold.outOfSample.totalReturn;
+        }
+        wf_ok = wf_ok && matched;
+    }
+
+    std::cout << "Walk-forward test: " << (wf_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 16: universe batch analysis ----
+    // AnalyzeSeries matches the pipeline and selector run separately
+    TickerAnalysis single = AnalyzeSeries("TEST", upToZero);
+    IndicatorPipeline singlePipeline;
+    const IndicatorResults& singleInd = singlePipeline.Run(upToZero);
+    auto singleStrategies = DefaultStrategies();
+    StrategyEvaluation singleEval = StrategySelector().evaluate(singleStrategies, upToZero);
+    bool universe_ok = single.ticker == "TEST" && single.load.status == LoadStatus::Ok &&
+                       approxEqual(single.indicators.sharpe, singleInd.sharpe, 1e-12) &&
+                       approxEqual(single.indicators.hurst, singleInd.hurst, 1e-12) &&
+                       single.evaluation.best != nullptr &&
+                       single.evaluation.bestPerformance.strategyName ==
+                           singleEval.bestPerformance.strategyName &&
+                       approxEqual(single.signal, singleEval.best->analyze(upToZero), 1e-12);
+
+    std::string universeError;
+    std::vector<std::string> listed = ResolveUniverse(" AAPL, ,MSFT ", universeError);
+    universe_ok = universe_ok && listed == std::vector<std::string>{ "AAPL", "MSFT" } &&
+                  TickerName("data/NVDA.csv") == "NVDA" && TickerName("AAPL") == "AAPL" &&
+                  std::string(SignalAction(12.0)) == "STRONG BUY" &&
+                  std::string(SignalAction(0.0)) == "HOLD / NEUTRAL";
+
+    // A directory of CSVs: the larger one is analyzed first on a one-worker
+    // pool, and duplicate keys are reported once
+    namespace fs = std::filesystem;
+    fs::path universeDir = fs::temp_directory_path() / "stocks_universe_test";
+    fs::remove_all(universeDir);
+    fs::create_directories(universeDir);
+    auto writeCsv = [&](const std::string& name, size_t rows) {
+        std::ofstream out(universeDir / (name + ".csv"));
+        out << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            double c = upToZero.Close()[i];
+            out << FormatDate(upToZero.Date(i)) << "," << c << "," << c << "," << c << ","
+                << c << "," << c << ",1000\n";
+        }
+    };
+    writeCsv("SMALL", 60);
+    writeCsv("BIG", 400);
+
+    std::vector<std::string> dirKeys = ResolveUniverse(universeDir.string(), universeError);
+    universe_ok = universe_ok && dirKeys.size() == 2 && TickerName(dirKeys[0]) == "BIG";
+    dirKeys.push_back(dirKeys[0]);
+
+    std::vector<std::string> reported;
+    std::vector<size_t> reportedRows;
+    ThreadPool universePool(1);
+    RunUniverse(dirKeys, [&](TickerAnalysis& a) {
+        reported.push_back(a.ticker);
+        reportedRows.push_back(a.load.status == LoadStatus::Ok ? a.load.series.size() : 0);
+    }, universePool);
+    universe_ok = universe_ok && reported == std::vector<std::string>{ "BIG", "SMALL" } &&
+                  reportedRows == std::vector<size_t>{ 400, 60 };
+
+    // A throwing callback is not called again, and the exception surfaces
+    // only after every task has finished with this call's state
+    ThreadPool throwingPool(4);
+    int throwingCalls = 0;
+    bool rethrown = false;
+    try {
+        RunUniverse(dirKeys, [&](TickerAnalysis&) {
+            ++throwingCalls;
+            throw std::runtime_error("report failed");
+        }, throwingPool);
+    } catch (const std::runtime_error& e) {
+        rethrown = std::string(e.what()) == "report failed";
+    }
+    universe_ok = universe_ok && rethrown && throwingCalls == 1;
+    fs::remove_all(universeDir);
+
+    std::cout << "Universe test: " << (universe_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 17: date-aligned portfolio ----
+    // A trades days 0..9 except day 4; B lists on day 3 and delists after day 7
+    std::vector<StockData> barsA, barsB;
+    for (int d = 0; d < 10; ++d) {
+        if (d != 4) barsA.push_back({ d, 0, 0, 0, 100.0 + d, 0 });
+        if (d >= 3 && d <= 7) barsB.push_back({ d, 0, 0, 0, 50.0 * (1.0 + 0.1 * (d - 3)), 0 });
+    }
+    AlignedPanel panel({ "A", "B" }, { PriceSeries(barsA), PriceSeries(barsB) });
+    bool portfolio_ok = panel.rows() == 10 && panel.cols() == 2 &&
+                        panel.FirstRow(1) == 3 && panel.LastRow(1) == 7 &&
+                        approxEqual(panel.CloseRow(4)[0], 103.0) &&    // A forward-filled
+                        panel.ListedRow(4)[0] == 1 &&
+                        panel.ListedRow(2)[1] == 0 && panel.CloseRow(2)[1] == 0.0 &&
+                        panel.ListedRow(8)[1] == 0 && approxEqual(panel.CloseRow(9)[1], 70.0);
+
+    // Long both, rebalanced daily: each day earns the mean return of the
+    // listed tickers
+    std::vector<double> allLong(panel.rows() * panel.cols(), 1.0);
+    PortfolioSpec daily;
+    daily.rebalanceEvery = 1;
+    PortfolioResult dailyResult = RunPortfolio(panel, allLong, daily);
+    double expected = 1.0;
+    for (size_t row = 0; row + 1 < panel.rows(); ++row) {
+        double sum = 0.0;
+        int count = 0;
+        for (size_t j = 0; j < 2; ++j) {
+            if (!panel.ListedRow(row)[j]) continue;
+            sum += panel.CloseRow(row + 1)[j] / panel.CloseRow(row)[j] - 1.0;
+            ++count;
+        }
+        expected *= 1.0 + sum / count;
+        portfolio_ok = portfolio_ok && approxEqual(dailyResult.equity[row + 1], expected, 1e-12);
+    }
+    portfolio_ok = portfolio_ok && dailyResult.rebalances == 9 &&
+                   approxEqual(dailyResult.performance.totalReturn, expected - 1.0, 1e-12) &&
+                   approxEqual(dailyResult.finalWeights[0], 1.0, 1e-12);
+
+    // Buy & hold of A alone, never rebalanced, is A's own buy & hold
+    BuyAndHoldStrategy holdA;
+    AlignedPanel onlyA({ "A" }, { PriceSeries(barsA) });
+    PortfolioSpec once;
+    once.rebalanceEvery = 1000;
+    PortfolioResult holdResult = RunPortfolio(onlyA, holdA, once);
+    portfolio_ok = portfolio_ok && holdResult.rebalances == 1 &&
+                   approxEqual(holdResult.performance.totalReturn, 109.0 / 100.0 - 1.0, 1e-12) &&
+                   approxEqual(holdResult.performance.turnover, 1.0);
+
+    // Short positions stay in cash unless allowed
+    std::vector<double> allShort(onlyA.rows(), -1.0);
+    PortfolioSpec shorting;
+    shorting.allowShort = true;
+    portfolio_ok = portfolio_ok &&
+                   approxEqual(RunPortfolio(onlyA, allShort).performance.totalReturn, 0.0) &&
+                   RunPortfolio(onlyA, allShort, shorting).performance.totalReturn < 0.0;
+
+    std::cout << "Portfolio test: " << (portfolio_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 18: static strategies vs. the virtual ones ----
+    auto sameSignals = [](const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::isnan(a[i]) != std::isnan(b[i])) return false;
+            if (!std::isnan(a[i]) && !approxEqual(a[i], b[i], 1e-9 * std::max(1.0, std::fabs(a[i])))) return false;
+        }
+        return true;
+    };
+    auto sameBacktest = [](const BacktestResult& a, const BacktestResult& b) {
+        return approxEqual(a.totalReturn, b.totalReturn, 1e-9) &&
+               approxEqual(a.maxDrawdown, b.maxDrawdown, 1e-9) &&
+               approxEqual(a.winRate, b.winRate, 1e-12) &&
+               approxEqual(a.turnover, b.turnover, 1e-12) && a.trades == b.trades;
+    };
+    // The AnalysisStrategy default: analyzeSeries through positionRule
+    auto virtualBacktest = [](AnalysisStrategy& s, const PriceSeries& data) {
+        std::vector<double> signals = s.analyzeSeries(data);
+        return RunBacktest(data.Close(), signals.data(), s.positionRule());
+    };
+
+    TrendingStrategy trendVirtual(30, 2.5);
+    MeanReversionStrategy reversionVirtual(15, 2.5);
+    BuyAndHoldStrategy holdVirtual;
+    TrendingSignal trendStatic(30, 2.5);
+    MeanReversionSignal reversionStatic(15, 2.5);
+    BuyAndHoldSignal holdStatic;
+
+    bool static_ok = sameSignals(trendStatic.Signals(upToZero), trendVirtual.analyzeSeries(upToZero)) &&
+                     sameSignals(reversionStatic.Signals(upToZero), reversionVirtual.analyzeSeries(upToZero)) &&
+                     sameSignals(holdStatic.Signals(upToZero), holdVirtual.analyzeSeries(upToZero)) &&
+                     sameBacktest(trendStatic.Backtest(upToZero), virtualBacktest(trendVirtual, upToZero)) &&
+                     sameBacktest(reversionStatic.Backtest(upToZero), virtualBacktest(reversionVirtual, upToZero)) &&
+                     sameBacktest(holdStatic.Backtest(upToZero), virtualBacktest(holdVirtual, upToZero)) &&
+                     sameBacktest(trendVirtual.backtest(upToZero), virtualBacktest(trendVirtual, upToZero));
+
+    // TrendingStrategy signals and backtests share one SMA, so the virtual
+    // and fused paths agree exactly, not just to rounding
+    std::vector<double> trendSignals = trendVirtual.analyzeSeries(upToZero);
+    std::vector<double> trendFused = trendStatic.Signals(upToZero);
+    BacktestResult trendBacktest = trendVirtual.backtest(upToZero);
+    BacktestResult trendFromSignals = virtualBacktest(trendVirtual, upToZero);
+    const double trendCurrent = trendVirtual.analyze(upToZero);
+    static_ok = static_ok && trendSignals.size() == trendFused.size() &&
+                std::memcmp(trendSignals.data(), trendFused.data(), trendSignals.size() * sizeof(double)) == 0 &&
+                std::memcmp(&trendCurrent, &trendSignals.back(), sizeof(double)) == 0 &&
+                trendBacktest.totalReturn == trendFromSignals.totalReturn &&
+                trendBacktest.maxDrawdown == trendFromSignals.maxDrawdown &&
+                trendBacktest.winRate == trendFromSignals.winRate &&
+                trendBacktest.turnover == trendFromSignals.turnover &&
+                trendBacktest.trades == trendFromSignals.trades;
+
+    // Backtest() starts from a fresh state every time, and the variant
+    // dispatches to the same instantiation
+    StaticStrategyVariant variant = MeanReversionSignal(15, 2.5);
+    static_ok = static_ok &&
+                sameBacktest(reversionStatic.Backtest(upToZero), reversionStatic.Backtest(upToZero)) &&
+                sameBacktest(Backtest(variant, upToZero), virtualBacktest(reversionVirtual, upToZero)) &&
+                StrategyName(variant) == reversionVirtual.getName() &&
+                std::string(TrendingSignal::Name()) == trendVirtual.getName() &&
+                std::string(BuyAndHoldSignal::Name()) == holdVirtual.getName();
+
+    std::cout << "Static strategy test: " << (static_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 19: JSON output and the analysis server protocol ----
+    JsonWriter json;
+    json.BeginObject()
+        .Key("name").String("a\"b\\c\n")
+        .Key("values").BeginArray().Number(0.1).Number(std::nan("")).Int(-3).Bool(true).EndArray()
+        .Key("empty").BeginObject().EndObject()
+        .EndObject();
+    bool server_ok = json.str() == "{\"name\":\"a\\\"b\\\\c\\n\",\"values\":[0.1,null,-3,true],\"empty\":{}}";
+
+    // Requests go straight to Handle(); no socket is opened
+    fs::path serverDir = fs::temp_directory_path() / "stocks_server_test";
+    fs::remove_all(serverDir);
+    fs::create_directories(serverDir);
+    const std::string serverCsv = (serverDir / "SRV.csv").string();
+    auto writeServerCsv = [&](size_t rows) {
+        std::ofstream out(serverCsv);
+        out << "Date,Open,High,Low,Close,Adj Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            double c = upToZero.Close()[i];
+            out << FormatDate(upToZero.Date(i)) << "," << c << "," << c << "," << c << ","
+                << c << "," << c << ",1000\n";
+        }
+    };
+    writeServerCsv(300);
+
+    {
+        AnalysisServer server((serverDir / "test.sock").string());
+        auto contains = [](const std::string& text, const std::string& part) {
+            return text.find(part) != std::string::npos;
+        };
+        std::string first = server.Handle("analyze " + serverCsv);
+        std::string second = server.Handle("  analyze " + serverCsv + "\r");
+        server_ok = server_ok && server.Handle("ping") == "{\"ok\":true,\"pong\":true}" &&
+                    contains(first, "\"ok\":true,\"cached\":false") &&
+                    contains(first, "\"rows\":300") && contains(first, "\"strategies\":[{") &&
+                    contains(second, "\"cached\":true") &&
+                    contains(server.Handle("frobnicate"), "\"ok\":false") &&
+                    contains(server.Handle("analyze"), "\"ok\":false");
+
+        // Rewriting the CSV makes the next request rebuild the analysis
+        writeServerCsv(320);
+        std::string rebuilt = server.Handle("analyze " + serverCsv);
+        server_ok = server_ok && contains(rebuilt, "\"cached\":false") && contains(rebuilt, "\"rows\":320") &&
+                    server.Handle("invalidate *") == "{\"ok\":true,\"dropped\":1}" &&
+                    contains(server.Handle("stats"), "\"entries\":0,") &&
+                    contains(server.Handle("stats"), "\"hits\":1,\"misses\":2,\"invalidations\":2");
+    }
+
+    // The listener never deletes a path that is not a socket, and the socket
+    // is owner-only
+    {
+        const std::string notes = (serverDir / "notes.txt").string();
+        std::ofstream(notes) << "keep me\n";
+        std::string socketError;
+        bool refused = ListenUnixSocket(notes, socketError) < 0 && !socketError.empty();
+        RemoveUnixSocket(notes);
+        const std::string socketPath = (serverDir / "live.sock").string();
+        int listener = ListenUnixSocket(socketPath, socketError);
+        struct stat st;
+        bool ownerOnly = listener >= 0 && ::lstat(socketPath.c_str(), &st) == 0 &&
+                         S_ISSOCK(st.st_mode) && (st.st_mode & 0077) == 0;
+        bool busy = ListenUnixSocket(socketPath, socketError) < 0;
+        if (listener >= 0) ::close(listener);
+        RemoveUnixSocket(socketPath);
+        server_ok = server_ok && refused && fs::is_regular_file(notes) && ownerOnly && busy &&
+                    !fs::exists(socketPath);
+    }
+    fs::remove_all(serverDir);
+
+    std::cout << "Analysis server test: " << (server_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 20: JSON and binary report formats ----
+    // Numbers are written in the shortest form that reads back exactly
+    bool format_ok = true;
+    for (double value : { 0.1 + 0.2, 1e-300, 123456.789, -0.0025, 5e22 }) {
+        JsonWriter number;
+        number.Number(value);
+        format_ok = format_ok && std::strtod(number.str().c_str(), nullptr) == value;
+    }
+    format_ok = format_ok && JsonWriter().Number(0.5).str() == "0.5";
+
+    TickerAnalysis report = AnalyzeSeries("UPZ", upToZero);
+    std::string lines;
+    AppendAnalysis(report, OutputFormat::Json, true, lines);
+    AppendAnalysis(report, OutputFormat::Json, false, lines);
+    format_ok = format_ok && std::count(lines.begin(), lines.end(), '\n') == 2 &&
+                lines.find("\"series\":{\"date\":[\"") != std::string::npos &&
+                lines.find("\"series\"", lines.find('\n')) == std::string::npos;
+
+    std::string records;
+    AppendAnalysis(report, OutputFormat::Binary, true, records);
+    TickerAnalysis missing;
+    missing.ticker = "NONE";
+    missing.load.status = LoadStatus::NotFound;
+    AppendAnalysisBinary(missing, true, records);
+
+    uint16_t flags;
+    uint32_t size, rows, strategies, lags, scalars;
+    std::memcpy(&flags, records.data() + 6, 2);
+    std::memcpy(&size, records.data() + 8, 4);
+    std::memcpy(&rows, records.data() + 12, 4);
+    std::memcpy(&strategies, records.data() + 20, 4);
+    std::memcpy(&lags, records.data() + 24, 4);
+    std::memcpy(&scalars, records.data() + 28, 4);
+    // The close column follows the scalars, ACF, strategy table and dates
+    size_t closeAt = 32 + 8 * (scalars + lags + 5 * strategies) + ((4 * rows + 7) & ~size_t(7));
+    double lastClose;
+    std::memcpy(&lastClose, records.data() + closeAt + 8 * (rows - 1), 8);
+    uint16_t missingFlags;
+    uint32_t missingSize;
+    std::memcpy(&missingFlags, records.data() + size + 6, 2);
+    std::memcpy(&missingSize, records.data() + size + 8, 4);
+    format_ok = format_ok && records.compare(0, 4, "SSRB") == 0 && flags == kReportSeries &&
+                size % 8 == 0 && rows == upToZero.size() && strategies == 3 && lags == 20 &&
+                scalars == 15 && lastClose == upToZero.Close()[rows - 1] &&
+                missingFlags == kReportFailed && size + missingSize == records.size();
+
+    std::cout << "Report format test: " << (format_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 21: Arrow C Data Interface export ----
+    // The exported buffers are the columns themselves, and the owner lives
+    // until the table and every moved-out child have been released
+    auto owned = std::make_shared<std::vector<double>>(upToZero.Close().begin(), upToZero.Close().end());
+    std::weak_ptr<std::vector<double>> watch = owned;
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    ExportArrowTable(owned, owned->size(),
+                     { { "date", "tdD", upToZero.Dates().data() }, { "close", "g", owned->data() } },
+                     &arrowSchema, &arrowArray);
+    const double* closeValues = owned->data();
+    owned.reset();
+    bool arrow_ok = std::string(arrowSchema.format) == "+s" && arrowSchema.n_children == 2 &&
+                    std::string(arrowSchema.children[0]->format) == "tdD" &&
+                    std::string(arrowSchema.children[1]->name) == "close" &&
+                    arrowArray.length == static_cast<int64_t>(upToZero.size()) &&
+                    arrowArray.n_buffers == 1 && arrowArray.children[1]->n_buffers == 2 &&
+                    arrowArray.children[1]->buffers[0] == nullptr &&
+                    arrowArray.children[1]->buffers[1] == closeValues &&
+                    arrowArray.children[0]->buffers[1] == upToZero.Dates().data() &&
+                    !watch.expired();
+
+    ArrowArray movedColumn = *arrowArray.children[1];
+    arrowArray.children[1]->release = nullptr;
+    arrowSchema.release(&arrowSchema);
+    arrowArray.release(&arrowArray);
+    arrow_ok = arrow_ok && arrowSchema.release == nullptr && arrowArray.release == nullptr &&
+               !watch.expired();
+    movedColumn.release(&movedColumn);
+    arrow_ok = arrow_ok && watch.expired();
+
+    ArrowSchema seriesSchema;
+    ArrowArray seriesArray;
+    ExportPriceSeries(upToZero, &seriesSchema, &seriesArray);
+    std::vector<ArrowExportColumn> analysisColumns = AnalysisArrowColumns(report);
+    arrow_ok = arrow_ok && seriesSchema.n_children == 6 &&
+               seriesArray.children[4]->buffers[1] == upToZero.Close().data() &&
+               analysisColumns.size() == 12 && analysisColumns[7].name == "sma20" &&
+               analysisColumns[7].data == report.indicators.sma.data();
+    seriesSchema.release(&seriesSchema);
+    seriesArray.release(&seriesArray);
+
+    std::cout << "Arrow export test: " << (arrow_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 22: streaming engine ----
+    // Bars fed one at a time end in the same state as the batch computation,
+    // and every zone change after warm-up is reported exactly once
+    std::vector<SignalEvent> streamEvents;
+    StreamEngine streamEngine([&](const SignalEvent& e) { streamEvents.push_back(e); });
+    StreamDecoder binaryFeed(streamEngine);
+    StreamDecoder lineFeed(streamEngine);
+    binaryFeed.Feed(kStreamBinaryMagic, 2);
+    binaryFeed.Feed(kStreamBinaryMagic + 2, 2);
+    std::string streamLines = "# comment\n\n";
+    for (size_t i = 0; i < upToZero.size(); ++i) {
+        StreamBarRecord record{};
+        std::memcpy(record.ticker, "BIN", 3);
+        record.date = upToZero.Dates()[i];
+        record.open = record.high = record.low = record.close = upToZero.Close()[i];
+        // Split each record across two chunks
+        binaryFeed.Feed(reinterpret_cast<const char*>(&record), 10);
+        binaryFeed.Feed(reinterpret_cast<const char*>(&record) + 10, sizeof(record) - 10);
+
+        char line[96];
+        std::snprintf(line, sizeof(line), "LINE,%s,%.17g\n", FormatDate(upToZero.Dates()[i]).c_str(),
+                      upToZero.Close()[i]);
+        streamLines += line;
+    }
+    streamLines += "LINE,1970-01-01,10\nLINE,2099-01-01,-1\nLINE,oops\n";
+    std::vector<std::string> streamErrors;
+    lineFeed.Feed(streamLines.data(), streamLines.size(),
+                  [&](const std::string& error) { streamErrors.push_back(error); });
+    lineFeed.Finish();
+
+    std::vector<double> batchTrending = TrendingSignal().Signals(upToZero);
+    std::vector<double> batchReversion = MeanReversionSignal().Signals(upToZero);
+    size_t expectedEvents = 0;
+    for (const std::vector<double>* signals : { &batchTrending, &batchReversion }) {
+        const char* zone = nullptr;
+        for (double signal : *signals) {
+            if (std::isnan(signal)) continue;
+            const char* next = SignalAction(signal);
+            if (zone != nullptr && next != zone) ++expectedEvents;
+            zone = next;
+        }
+    }
+    const StreamSnapshot* binSnap = streamEngine.Snapshot("BIN");
+    const StreamSnapshot* lineSnap = streamEngine.Snapshot("LINE");
+    StreamStats streamStats = streamEngine.Stats();
+    IndicatorPipeline streamPipeline;
+    const IndicatorResults& streamBatch = streamPipeline.Run(upToZero);
+    bool stream_ok = binaryFeed.binary() && binSnap != nullptr && lineSnap != nullptr &&
+                     binSnap->bars == upToZero.size() && lineSnap->bars == upToZero.size() &&
+                     binSnap->trendingSignal == batchTrending.back() &&
+                     binSnap->meanReversionSignal == batchReversion.back() &&
+                     lineSnap->trendingSignal == batchTrending.back() &&
+                     std::fabs(binSnap->sma20 - streamBatch.sma.back()) < 1e-9 &&
+                     std::fabs(binSnap->bollingerUpper - streamBatch.bollingerUpper.back()) < 1e-9 &&
+                     streamStats.tickers == 2 && streamStats.bars == 2 * upToZero.size() &&
+                     streamStats.rejected == 3 && streamErrors.size() == 1 &&
+                     streamStats.events == 2 * expectedEvents && streamEvents.size() == streamStats.events &&
+                     streamEngine.Snapshot("NONE") == nullptr;
+
+    // A line longer than the cap is reported once and dropped, in whichever
+    // chunks it arrives, and the line after it still counts
+    StreamEngine cappedEngine([](const SignalEvent&) {});
+    StreamDecoder cappedFeed(cappedEngine);
+    std::vector<std::string> cappedErrors;
+    auto cappedError = [&](const std::string& error) { cappedErrors.push_back(error); };
+    std::string longLine = "LINE,2024-01-02," + std::string(StreamDecoder::kMaxLineBytes, '1');
+    cappedFeed.Feed("CAP,2024-01-02,10\n", 18, cappedError);
+    cappedFeed.Feed(longLine.data(), longLine.size() / 2, cappedError);
+    cappedFeed.Feed(longLine.data() + longLine.size() / 2, longLine.size() - longLine.size() / 2, cappedError);
+    cappedFeed.Feed(longLine.data(), longLine.size(), cappedError);
+    cappedFeed.Feed("\nCAP,2024-01-03,11\n", 19, cappedError);
+    cappedFeed.Feed(longLine.data(), longLine.size(), cappedError);
+    cappedFeed.Finish(cappedError);
+    const StreamSnapshot* cappedSnap = cappedEngine.Snapshot("CAP");
+    stream_ok = stream_ok && cappedErrors.size() == 2 && cappedSnap != nullptr && cappedSnap->bars == 2 &&
+                cappedEngine.Snapshot("LINE") == nullptr && cappedEngine.Stats().rejected == 0;
+
+    // The engine's latency histogram stays within its bucket precision
+    LatencyHistogram histogram;
+    stream_ok = stream_ok && histogram.Summary().p50 == 0.0;
+    for (int us = 1; us <= 1000; ++us) histogram.Add(us);
+    LatencySummary histogramSummary = histogram.Summary();
+    stream_ok = stream_ok && histogram.count() == 1000 &&
+                std::fabs(histogramSummary.p50 - 500.5) / 500.5 < 0.035 &&
+                std::fabs(histogramSummary.p99 - 990.0) / 990.0 < 0.035 &&
+                histogramSummary.max == 1000.0 && histogramSummary.mean == 500.5;
+    histogram.Add(1e-4);
+    histogram.Add(1e9);
+    stream_ok = stream_ok && histogram.Summary().max == 1e9 && histogram.count() == 1002;
+
+    // --stream --socket on a path that is not a socket fails and keeps the file
+    const fs::path streamFile = fs::temp_directory_path() / "stocks_stream_test.txt";
+    std::ofstream(streamFile) << "keep me\n";
+    std::string streamSocketError;
+    stream_ok = stream_ok && ServeStream(streamEngine, streamFile.string(), streamSocketError) == 1 &&
+                !streamSocketError.empty() && fs::is_regular_file(streamFile);
+    fs::remove(streamFile);
+    for (const SignalEvent& e : streamEvents) {
+        stream_ok = stream_ok && std::strcmp(e.from, e.to) != 0 && e.latencyUs >= 0.0 &&
+                    std::strcmp(SignalAction(e.signal), e.to) == 0;
+    }
+
+    std::cout << "Stream engine test: " << (stream_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 23: replay engine ----
+    // Synthetic data is reproducible, the merge is time ordered, and a replay
+    // leaves the engine where the batch strategies end
+    std::vector<ReplaySource> replaySources = SyntheticSources(3, 300, 7);
+    std::vector<ReplaySource> replayAgain = SyntheticSources(4, 300, 7);
+    replaySources.push_back({ "SLICE", upToZero.Slice(0, 100) });
+    std::vector<ReplayBar> merged = MergeSources(replaySources);
+    bool replay_ok = replaySources[0].ticker == "SYN00001" &&
+                     replayAgain[2].series.Close()[299] == replaySources[2].series.Close()[299] &&
+                     merged.size() == 1000;
+    for (const ReplaySource& source : replaySources) {
+        for (size_t i = 0; i < source.series.size(); ++i) {
+            replay_ok = replay_ok && source.series.Close()[i] > 0.0 &&
+                        source.series.Low()[i] <= source.series.Close()[i] &&
+                        source.series.High()[i] >= source.series.Close()[i] &&
+                        (i == 0 || source.series.Date(i) > source.series.Date(i - 1));
+        }
+    }
+    for (size_t i = 1; i < merged.size(); ++i) {
+        replay_ok = replay_ok && (merged[i - 1].date < merged[i].date ||
+                                  (merged[i - 1].date == merged[i].date && merged[i - 1].source < merged[i].source));
+    }
+
+    for (bool lineProtocol : { false, true }) {
+        StreamEngine replayEngine(nullptr);
+        ReplayOptions replayOptions;
+        replayOptions.lineProtocol = lineProtocol;
+        ReplayReport replayed = RunReplay(replaySources, replayOptions, replayEngine);
+        const StreamSnapshot* last = replayEngine.Snapshot("SYN00002");
+        replay_ok = replay_ok && replayed.error.empty() && replayed.bars == 1000 &&
+                    replayed.engine.bars == 1000 && replayed.engine.rejected == 0 &&
+                    replayed.tickers == 4 && replayed.barsPerSecond > 0.0 && last != nullptr &&
+                    last->trendingSignal == TrendingSignal().Signals(replaySources[1].series).back() &&
+                    last->meanReversionSignal == MeanReversionSignal().Signals(replaySources[1].series).back() &&
+                    replayed.endToEndUs.p50 <= replayed.endToEndUs.p99 &&
+                    replayed.endToEndUs.p99 <= replayed.endToEndUs.max && replayed.endToEndUs.p50 > 0.0;
+    }
+
+    // Tickers too long for a binary record are refused rather than
+    // truncated; the line protocol carries them whole
+    std::vector<ReplaySource> longNames = { { "LONGNAME1", upToZero.Slice(0, 50) },
+                                            { "LONGNAME2", upToZero.Slice(0, 50) } };
+    StreamEngine longEngine(nullptr);
+    ReplayReport refused = RunReplay(longNames, ReplayOptions(), longEngine);
+    replay_ok = replay_ok && refused.error.find("LONGNAME1") != std::string::npos &&
+                longEngine.Stats().bars == 0;
+    ReplayOptions longLines;
+    longLines.lineProtocol = true;
+    ReplayReport carried = RunReplay(longNames, longLines, longEngine);
+    replay_ok = replay_ok && carried.error.empty() && longEngine.Stats().bars == 100 &&
+                longEngine.Stats().tickers == 2 && longEngine.Snapshot("LONGNAME2") != nullptr;
+
+    // Paced: 30 weekdays span 40 market days, at 40 days per 50 ms
+    std::vector<ReplaySource> pacedSources = SyntheticSources(2, 30, 7);
+    StreamEngine pacedEngine(nullptr);
+    ReplayOptions paced;
+    paced.speed = 40 * 86400.0 / 0.05;
+    ReplayReport pacedReport = RunReplay(pacedSources, paced, pacedEngine);
+    replay_ok = replay_ok && pacedReport.error.empty() && pacedReport.days == 30 &&
+                pacedReport.wallSeconds >= 0.045 && pacedReport.engine.bars == 60;
+
+    std::cout << "Replay engine test: " << (replay_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 24: binary sidecar cache ----
+    // Round trip, invalidation by size and content but not by a bare touch,
+    // and refusal of truncated or corrupt sidecars
+    const fs::path cacheDir = fs::temp_directory_path() / "stocks_sidecar_test";
+    fs::remove_all(cacheDir);
+    fs::create_directories(cacheDir);
+    const std::string cacheCsv = (cacheDir / "SIDE.csv").string();
+    const std::string sidecar = SeriesCache::SidecarPath(cacheCsv);
+    auto writeSide = [&](double firstClose, size_t rows) {
+        std::ofstream out(cacheCsv);
+        out << "Date,Open,High,Low,Close,Volume\n";
+        for (size_t i = 0; i < rows; ++i) {
+            double c = i == 0 ? firstClose : upToZero.Close()[i];
+            out << FormatDate(upToZero.Date(i)) << "," << c << "," << c << "," << c << "," << c << ",1000\n";
+        }
+    };
+    auto storeSide = [&]() {
+        MappedFile csv;
+        std::string parseError;
+        if (!csv.Open(cacheCsv)) return false;
+        SeriesCache::SourceIdentity source = SeriesCache::Identify(csv);
+        return SeriesCache::Store(cacheCsv, source, PriceCsvParser::Parse(csv.view(), parseError));
+    };
+    auto bumpMtime = [&]() {
+        fs::last_write_time(cacheCsv, fs::last_write_time(cacheCsv) + std::chrono::seconds(5));
+    };
+    auto sameColumns = [](const PriceSeries& a, const PriceSeries& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a.Date(i) != b.Date(i) || a.Open()[i] != b.Open()[i] || a.High()[i] != b.High()[i] ||
+                a.Low()[i] != b.Low()[i] || a.Close()[i] != b.Close()[i] || a.Volume()[i] != b.Volume()[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    writeSide(10.5, 40);
+    PriceSeries parsedSide = StockDataLoader().LoadFromCSV(cacheCsv);
+    PriceSeries cached;
+    bool cache_ok = parsedSide.size() == 40 && storeSide() &&
+                    SeriesCache::Load(cacheCsv, cached) && sameColumns(cached, parsedSide);
+
+    // Touched but identical: the hash vouches for it
+    bumpMtime();
+    cache_ok = cache_ok && SeriesCache::Load(cacheCsv, cached) && sameColumns(cached, parsedSide);
+
+    // Same size, different bytes, new mtime: rejected
+    writeSide(10.6, 40);
+    bumpMtime();
+    cache_ok = cache_ok && !SeriesCache::Load(cacheCsv, cached);
+
+    // Different size: rejected without hashing
+    writeSide(10.5, 41);
+    cache_ok = cache_ok && !SeriesCache::Load(cacheCsv, cached);
+
+    // A sidecar stored with the identity of the bytes that were parsed stays
+    // stale when the CSV changes before Store runs
+    writeSide(10.5, 40);
+    {
+        MappedFile csv;
+        std::string parseError;
+        csv.Open(cacheCsv);
+        SeriesCache::SourceIdentity source = SeriesCache::Identify(csv);
+        PriceSeries early = PriceCsvParser::Parse(csv.view(), parseError);
+        csv.Close();
+        writeSide(10.7, 40);
+        bumpMtime();
+        cache_ok = cache_ok && SeriesCache::Store(cacheCsv, source, early) &&
+                   !SeriesCache::Load(cacheCsv, cached);
+    }
+
+    // Truncated sidecar, then one whose row count would wrap the column size
+    writeSide(10.5, 40);
+    cache_ok = cache_ok && storeSide() && SeriesCache::Load(cacheCsv, cached);
+    fs::resize_file(sidecar, fs::file_size(sidecar) - 100);
+    cache_ok = cache_ok && !SeriesCache::Load(cacheCsv, cached);
+    cache_ok = cache_ok && storeSide();
+    {
+        std::fstream ssb(sidecar, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t wrapping = (1ULL << 61) + 1;   // * sizeof(double) wraps to 8
+        ssb.seekp(16);
+        ssb.write(reinterpret_cast<const char*>(&wrapping), sizeof(wrapping));
+    }
+    cache_ok = cache_ok && !SeriesCache::Load(cacheCsv, cached);
+
+    // Concurrent stores of one ticker each write their own temporary file
+    std::vector<std::thread> storers;
+    std::atomic<int> stored{0};
+    for (int t = 0; t < 8; ++t) {
+        storers.emplace_back([&] { for (int k = 0; k < 20; ++k) stored += storeSide() ? 1 : 0; });
+    }
+    for (std::thread& t : storers) t.join();
+    size_t leftovers = 0;
+    for (const auto& entry : fs::directory_iterator(cacheDir)) {
+        if (entry.path().string().find(".tmp") != std::string::npos) ++leftovers;
+    }
+    cache_ok = cache_ok && stored == 160 && leftovers == 0 &&
+               SeriesCache::Load(cacheCsv, cached) && sameColumns(cached, parsedSide);
+    fs::remove_all(cacheDir);
+
+    std::cout << "Sidecar cache test: " << (cache_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 25: CSV parser edge cases ----
+    auto parseCsv = [](const std::string& text, std::string& error) {
+        error.clear();
+        return PriceCsvParser::Parse(text, error);
+    };
+    std::string csvError;
+    int32_t day1 = DaysFromCivil(2024, 1, 2), day2 = DaysFromCivil(2024, 1, 3);
+
+    // CRLF endings, a BOM, and a last line without a newline
+    PriceSeries crlf = parseCsv("\xEF\xBB\xBF" "Date,Open,High,Low,Close,Volume\r\n"
+                                "2024-01-02,1,2,0.5,1.5,100\r\n"
+                                "2024-01-03,1.5,2.5,1,2,200", csvError);
+    bool csv_ok = csvError.empty() && crlf.size() == 2 && crlf.Date(0) == day1 &&
+                  crlf.Date(1) == day2 && crlf.Close()[0] == 1.5 && crlf.Close()[1] == 2.0 &&
+                  crlf.Volume()[1] == 200.0 && crlf.High()[1] == 2.5 && crlf.Low()[0] == 0.5;
+
+    // Blank lines anywhere are skipped; a leading index column is ignored
+    PriceSeries blanks = parseCsv(",Date,Close\n\n0,2024-01-02,10\n\r\n1,2024-01-03,11\n\n", csvError);
+    csv_ok = csv_ok && blanks.size() == 2 && blanks.Close()[1] == 11.0 &&
+             blanks.Open()[1] == 11.0 && blanks.Volume()[1] == 0.0;
+
+    // Adj Close only when there is no Close; Close wins when both exist
+    PriceSeries adjOnly = parseCsv("Date,Adj Close\n2024-01-02,7.5\n", csvError);
+    PriceSeries both = parseCsv("date,adj_close,CLOSE\n2024-01-02,7.5,8\n", csvError);
+    csv_ok = csv_ok && adjOnly.size() == 1 && adjOnly.Close()[0] == 7.5 &&
+             both.size() == 1 && both.Close()[0] == 8.0;
+
+    // Missing or non-numeric prices and bad dates drop the row; a blank or
+    // non-numeric volume reads as 0; an explicit plus sign is a number
+    PriceSeries cells = parseCsv("Date,Open,High,Low,Close,Volume\n"
+                                 "2024-01-02,1,2,0.5,,100\n"
+                                 "2024-01-03,null,2,0.5,1.5,100\n"
+                                 "not a date,1,2,0.5,1.5,100\n"
+                                 "2024-01-04,1,2,0.5\n"
+                                 "2024-01-05,1,2,0.5,1.5,\n"
+                                 "2024-01-08,1,2,0.5,+1.5,n/a\n"
+                                 "2024-01-09,1,2,0.5,+-1.5,1\n", csvError);
+    csv_ok = csv_ok && csvError.empty() && cells.size() == 2 &&
+             cells.Date(0) == DaysFromCivil(2024, 1, 5) && cells.Volume()[0] == 0.0 &&
+             cells.Date(1) == DaysFromCivil(2024, 1, 8) && cells.Close()[1] == 1.5 &&
+             cells.Volume()[1] == 0.0;
+
+    // A header without date or close columns is an error
+    PriceSeries noClose = parseCsv("Date,Open\n2024-01-02,1\n", csvError);
+    csv_ok = csv_ok && noClose.empty() && !csvError.empty();
+    PriceSeries empty = parseCsv("Date,Close\n", csvError);
+    csv_ok = csv_ok && empty.empty() && csvError.empty();
+
+    std::cout << "CSV parser test: " << (csv_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 26: work-stealing thread pool ----
+    bool pool_ok = true;
+    {
+        // Results and exceptions come back through the futures, and the
+        // destructor runs every queued task before joining
+        std::atomic<int> ran{0};
+        std::future<int> answer;
+        std::future<void> thrown;
+        {
+            ThreadPool one(1);
+            answer = one.Submit([] { return 42; });
+            thrown = one.Submit([] { throw std::runtime_error("task failed"); });
+            for (int k = 0; k < 100; ++k) one.Submit([&] { ++ran; });
+        }
+        bool rethrew = false;
+        try {
+            thrown.get();
+        } catch (const std::runtime_error&) {
+            rethrew = true;
+        }
+        pool_ok = answer.get() == 42 && rethrew && ran == 100;
+    }
+    {
+        // ParallelFor nested inside pool tasks (and inside itself) on the
+        // same small pool finishes every iteration instead of deadlocking
+        ThreadPool small(2);
+        std::vector<std::atomic<int>> hits(4 * 500);
+        std::vector<std::future<void>> outer;
+        for (size_t t = 0; t < 4; ++t) {
+            outer.push_back(small.Submit([&, t] {
+                ParallelFor(50, [&](size_t block) {
+                    ParallelFor(10, [&](size_t i) { ++hits[t * 500 + block * 10 + i]; }, small);
+                }, small);
+            }));
+        }
+        for (auto& f : outer) f.get();
+        pool_ok = pool_ok && std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; });
+
+        bool parallelThrew = false;
+        try {
+            ParallelFor(100, [](size_t i) { if (i == 37) throw std::runtime_error("iteration failed"); }, small);
+        } catch (const std::runtime_error&) {
+            parallelThrew = true;
+        }
+        pool_ok = pool_ok && parallelThrew;
+    }
+
+    std::cout << "Thread pool test: " << (pool_ok ? "PASS" : "FAIL") << "\n";
+
+    // ---- Test 27: concurrent loader ----
+    // Duplicates load once, results are keyed (and so ordered) by ticker,
+    // and every ticker gets its own status
+    const fs::path loaderDir = fs::temp_directory_path() / "stocks_loader_test";
+    fs::remove_all(loaderDir);
+    fs::create_directories(loaderDir);
+    auto writeLoaderCsv = [&](const std::string& name, const std::string& header, size_t rows) {
+        std::ofstream out(loaderDir / name);
+        out << header << "\n";
+        for (size_t i = 0; i < rows; ++i) out << FormatDate(upToZero.Date(i)) << "," << upToZero.Close()[i] << "\n";
+        return (loaderDir / name).string();
+    };
+    const std::string loadA = writeLoaderCsv("A.csv", "Date,Close", 30);
+    const std::string loadB = writeLoaderCsv("B.csv", "Date,Close", 45);
+    const std::string loadBad = writeLoaderCsv("BAD.csv", "Date,Price", 10);
+    const std::string loadMissing = (loaderDir / "MISSING.csv").string();
+
+    std::map<std::string, TickerLoadResult> loadedMany = StockDataLoader().LoadByTickers(
+        { loadB, loadA, loadMissing, loadB, loadBad, loadA }, false, 3);
+    std::vector<std::string> loadedKeys;
+    for (const auto& entry : loadedMany) loadedKeys.push_back(entry.first);
+    std::vector<std::string> sortedKeys = { loadA, loadB, loadBad, loadMissing };
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+    bool loader_ok = loadedKeys == sortedKeys &&
+                     loadedMany[loadA].status == LoadStatus::Ok && loadedMany[loadA].series.size() == 30 &&
+                     loadedMany[loadB].status == LoadStatus::Ok && loadedMany[loadB].series.size() == 45 &&
+                     loadedMany[loadB].source == loadB && !loadedMany[loadB].fromAPI &&
+                     loadedMany[loadBad].status == LoadStatus::ParseError && !loadedMany[loadBad].error.empty() &&
+                     loadedMany[loadMissing].status == LoadStatus::NotFound &&
+                     loadedMany[loadMissing].series.empty() &&
+                     StockDataLoader().LoadByTickers({}, false).empty();
+
+    // The second load of an unchanged CSV is served from its sidecar
+    std::map<std::string, TickerLoadResult> reloaded = StockDataLoader().LoadByTickers({ loadA }, false);
+    loader_ok = loader_ok && reloaded[loadA].fromCache && reloaded[loadA].series.size() == 30;
+    fs::remove_all(loaderDir);
+
+    std::cout << "Concurrent loader test: " << (loader_ok ? "PASS" : "FAIL") << "\n";
+
     return 0;
 }
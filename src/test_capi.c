@@ -0,0 +1,147 @@
+/* C-only checks of the libstocksense ABI (stocksense_c.h).
+ *
+ * Build and run from src:
+ *   g++ -std=c++17 -O2 -fPIC -shared -fvisibility=hidden stocksense_c.cpp
+ *       StockDataLoader.cpp StockAnalytics.cpp MappedFile.cpp
+ *       PriceCsvParser.cpp SeriesCache.cpp Fft.cpp SimdKernels.cpp
+ *       IndicatorPipeline.cpp Universe.cpp ArrowExport.cpp
+ *       -o libstocksense.so -lpthread -lcurl
+ *   gcc -std=c99 -Wall test_capi.c -L. -lstocksense -Wl,-rpath,. -lm -o test_capi
+ *   ./test_capi
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "stocksense_c.h"
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    printf("%s: %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+int main(void) {
+    enum { N = 300 };
+    int32_t dates[N];
+    double close[N];
+    int i;
+    for (i = 0; i < N; ++i) {
+        dates[i] = 19000 + i;
+        close[i] = 100.0 + 10.0 * sin(i / 15.0) + 0.05 * i;
+    }
+
+    /* ---- Version and errors ---- */
+    check(ss_abi_version() == SS_ABI_VERSION, "ABI version test");
+    check(ss_analyze_series("BAD", 0, dates, NULL, NULL, NULL, close, NULL) == NULL &&
+          strlen(ss_last_error()) > 0 &&
+          ss_analyze_ticker("", 0) == NULL &&
+          ss_analyze_ticker("NO_SUCH_TICKER_XYZ", 0) == NULL,
+          "Error reporting test");
+
+    /* ---- Caller-provided series ---- */
+    {
+        ss_analysis* a = ss_analyze_series("SINE", N, dates, NULL, NULL, NULL, close, NULL);
+        const double* c = ss_column(a, SS_COL_CLOSE);
+        const double* ret = ss_column(a, SS_COL_RETURN);
+        const double* sma = ss_column(a, SS_COL_SMA);
+        const double* upper = ss_column(a, SS_COL_BB_UPPER);
+        const double* lower = ss_column(a, SS_COL_BB_LOWER);
+        const double* signal = ss_column(a, SS_COL_SIGNAL);
+        const int32_t* d = ss_dates(a);
+        double average = 0.0;
+        int ok = a != NULL && ss_rows(a) == N && strcmp(ss_ticker(a), "SINE") == 0 &&
+                 c && ret && sma && upper && lower && signal && d &&
+                 c[N - 1] == close[N - 1] && d[N - 1] == dates[N - 1] &&
+                 isnan(ret[0]) && fabs(ret[1] - (close[1] / close[0] - 1.0)) < 1e-12 &&
+                 ss_column(a, (ss_column_id)99) == NULL;
+        for (i = N - 20; i < N; ++i) average += close[i] / 20.0;
+        ok = ok && fabs(sma[N - 1] - average) < 1e-9 && upper[N - 1] > sma[N - 1] &&
+             lower[N - 1] < sma[N - 1];
+        check(ok, "Series columns test");
+
+        {
+            ss_summary s;
+            ss_strategy best;
+            size_t lags = 0;
+            const double* acf = ss_acf(a, &lags);
+            const char* json = ss_report_json(a, 1);
+            memset(&s, 0, sizeof(s));
+            s.struct_size = sizeof(s);
+            memset(&best, 0, sizeof(best));
+            best.struct_size = sizeof(best);
+            ok = ss_get_summary(a, &s) == 0 && s.latest_close == close[N - 1] &&
+                 s.latest_date == dates[N - 1] && fabs(s.sma20 - sma[N - 1]) < 1e-12 &&
+                 s.signal == signal[N - 1] && strlen(s.recommended) > 0 && strlen(s.action) > 0 &&
+                 ss_strategy_count(a) == 3 && ss_get_strategy(a, 0, &best) == 0 &&
+                 strcmp(best.name, s.recommended) == 0 &&
+                 ss_get_strategy(a, 3, &best) == -1 &&
+                 acf != NULL && lags == 20 &&
+                 json != NULL && strstr(json, "\"ticker\":\"SINE\"") && strstr(json, "\"series\":{") &&
+                 ss_report_json(a, 1) == json;
+            check(ok, "Summary and strategies test");
+        }
+
+        /* An older caller's smaller struct gets only the fields it knows */
+        {
+            ss_summary small[2];
+            memset(small, 0x7f, sizeof(small));
+            small[0].struct_size = (uint32_t)offsetof(ss_summary, sma20);
+            ok = ss_get_summary(a, &small[0]) == 0 && small[0].latest_close == close[N - 1] &&
+                 small[0].struct_size == offsetof(ss_summary, sma20) &&
+                 ((const unsigned char*)&small[0])[offsetof(ss_summary, sma20)] == 0x7f;
+            check(ok, "Struct size test");
+        }
+        ss_free(a);
+    }
+    ss_free(NULL);
+
+    /* ---- Arrow export outlives the handle ---- */
+    {
+        ss_analysis* a = ss_analyze_series("ARW", N, dates, NULL, NULL, NULL, close, NULL);
+        struct ArrowSchema schema;
+        struct ArrowArray array;
+        struct ArrowArray moved;
+        const double* sma = ss_column(a, SS_COL_SMA);
+        int64_t c, smaChild = -1, closeChild = -1;
+        int ok = ss_export_arrow(a, &schema, &array) == 0 && strcmp(schema.format, "+s") == 0 &&
+                 array.length == N && array.n_children == schema.n_children &&
+                 schema.n_children == 13 && strcmp(schema.children[0]->format, "tdD") == 0 &&
+                 ((const int32_t*)array.children[0]->buffers[1])[N - 1] == dates[N - 1];
+        for (c = 0; ok && c < schema.n_children; ++c) {
+            if (strcmp(schema.children[c]->name, "sma20") == 0) smaChild = c;
+            if (strcmp(schema.children[c]->name, "close") == 0) closeChild = c;
+        }
+        /* Zero-copy: the Arrow buffer is the ss_column memory */
+        ok = ok && smaChild >= 0 && closeChild >= 0 &&
+             array.children[smaChild]->buffers[1] == (const void*)sma &&
+             array.children[smaChild]->n_buffers == 2 && array.children[smaChild]->buffers[0] == NULL;
+        ss_free(a);
+
+        /* Move one column out (as a consumer may), then release the table */
+        moved = *array.children[closeChild];
+        array.children[closeChild]->release = NULL;
+        ok = ok && ((const double*)array.children[smaChild]->buffers[1])[N - 1] == sma[N - 1];
+        schema.release(&schema);
+        array.release(&array);
+        ok = ok && schema.release == NULL && array.release == NULL &&
+             ((const double*)moved.buffers[1])[N - 1] == close[N - 1];
+        moved.release(&moved);
+        check(ok && moved.release == NULL, "Arrow export test");
+    }
+
+    /* ---- Bundled ticker through the loader ---- */
+    {
+        ss_analysis* a = ss_analyze_ticker("AAPL.csv", 0);
+        ss_summary s;
+        memset(&s, 0, sizeof(s));
+        s.struct_size = sizeof(s);
+        check(a != NULL && ss_rows(a) > 1000 && strcmp(ss_ticker(a), "AAPL") == 0 &&
+              ss_get_summary(a, &s) == 0 && s.latest_close == ss_column(a, SS_COL_CLOSE)[ss_rows(a) - 1],
+              "Ticker load test");
+        ss_free(a);
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}